@@ -0,0 +1,260 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+// 基准测试工具，供 exp1 与 exp4 共用：
+// 每个用例先预热若干次，再重复计时(steady_clock 墙钟时间)，报告中位数、p95、均值、标准差；
+// 可选地用 perf_event_open 读取 CPU 周期、指令数、缓存缺失(仅 Linux，无权限时自动关闭)；
+// 全部结果可输出为表格、CSV 或 JSON，便于在不同构建之间比较。
+
+struct BenchmarkOptions {
+    int warmup = 1;
+    int trials = 5;
+    bool counters = false;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    int trials = 0;
+    double median = 0.0;       // 秒
+    double p95 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    bool hasCounters = false;  // 以下为每次试验的平均值
+    double cycles = 0.0;
+    double instructions = 0.0;
+    double cacheMisses = 0.0;
+};
+
+// 硬件计数器：周期、指令、缓存缺失各开一个事件，inherit 使之后创建的线程也被计入
+class PerfCounters {
+public:
+    static constexpr int EVENTS = 3;
+
+    PerfCounters() {
+#if defined(__linux__)
+        const unsigned long long configs[EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+        for (int e = 0; e < EVENTS; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[e] < 0) {
+                close();
+                return;
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        close();
+    }
+
+    bool available() const { return fds[0] >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // 停止计数并读出 {周期, 指令, 缓存缺失}
+    void stop(double values[EVENTS]) {
+        for (int e = 0; e < EVENTS; ++e) {
+            values[e] = 0.0;
+#if defined(__linux__)
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+            unsigned long long count = 0;
+            if (read(fds[e], &count, sizeof(count)) == sizeof(count)) values[e] = static_cast<double>(count);
+#endif
+        }
+    }
+
+private:
+    int fds[EVENTS] = {-1, -1, -1};
+
+    void close() {
+        for (int& fd : fds) {
+#if defined(__linux__)
+            if (fd >= 0) ::close(fd);
+#endif
+            fd = -1;
+        }
+    }
+};
+
+class Benchmark {
+private:
+    BenchmarkOptions options;
+    std::vector<BenchmarkResult> collected;
+
+public:
+    explicit Benchmark(BenchmarkOptions opts = BenchmarkOptions()) : options(opts) {
+        if (options.trials < 1) options.trials = 1;
+    }
+
+    const BenchmarkOptions& config() const { return options; }
+    const std::vector<BenchmarkResult>& results() const { return collected; }
+
+    // setup 在每次运行前执行且不计时(例如复制输入)，body 为被测代码
+    template<typename Setup, typename Body>
+    const BenchmarkResult& run(const std::string& name, Setup setup, Body body) {
+        for (int w = 0; w < options.warmup; ++w) {
+            setup();
+            body();
+        }
+
+        std::unique_ptr<PerfCounters> counters;
+        if (options.counters) counters.reset(new PerfCounters());
+        bool counting = counters && counters->available();
+        double totals[PerfCounters::EVENTS] = {0.0, 0.0, 0.0};
+
+        std::vector<double> samples;
+        samples.reserve(options.trials);
+        for (int t = 0; t < options.trials; ++t) {
+            setup();
+            if (counting) counters->start();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (counting) {
+                double values[PerfCounters::EVENTS];
+                counters->stop(values);
+                for (int e = 0; e < PerfCounters::EVENTS; ++e) totals[e] += values[e];
+            }
+            samples.push_back(elapsed.count());
+        }
+
+        BenchmarkResult result = summarize(name, samples);
+        if (counting) {
+            result.hasCounters = true;
+            result.cycles = totals[0] / options.trials;
+            result.instructions = totals[1] / options.trials;
+            result.cacheMisses = totals[2] / options.trials;
+        }
+        collected.push_back(result);
+        return collected.back();
+    }
+
+    template<typename Body>
+    const BenchmarkResult& run(const std::string& name, Body body) {
+        return run(name, [] {}, body);
+    }
+
+    void printTable(std::ostream& os) const {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::left << std::setw(40) << "name" << std::right
+           << std::setw(12) << "median(ms)" << std::setw(12) << "p95(ms)" << std::setw(12) << "stddev(ms)";
+        bool counters = std::any_of(collected.begin(), collected.end(),
+                                    [](const BenchmarkResult& r) { return r.hasCounters; });
+        if (counters) os << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(14) << "cache-miss";
+        os << "\n";
+        for (const auto& r : collected) {
+            os << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(3)
+               << std::setw(12) << r.median * 1e3 << std::setw(12) << r.p95 * 1e3 << std::setw(12) << r.stddev * 1e3;
+            if (r.hasCounters) {
+                os << std::setw(16) << count(r.cycles) << std::setw(16) << count(r.instructions)
+                   << std::setw(14) << count(r.cacheMisses);
+            }
+            os << "\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    void writeCsv(std::ostream& os) const {
+        os << "name,trials,median_s,p95_s,mean_s,stddev_s,min_s,cycles,instructions,cache_misses\n";
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::defaultfloat << std::setprecision(9);
+        for (const auto& r : collected) {
+            os << '"';
+            for (char c : r.name) os << (c == '"' ? "\"\"" : std::string(1, c));
+            os << '"' << ',' << r.trials << ',' << r.median << ',' << r.p95 << ',' << r.mean << ','
+               << r.stddev << ',' << r.min << ',';
+            if (r.hasCounters) os << count(r.cycles) << ',' << count(r.instructions) << ',' << count(r.cacheMisses);
+            else os << ",,";
+            os << "\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    void writeJson(std::ostream& os) const {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::defaultfloat << std::setprecision(9) << "[\n";
+        for (size_t i = 0; i < collected.size(); ++i) {
+            const auto& r = collected[i];
+            os << "  {\"name\": \"";
+            for (char c : r.name) {
+                if (c == '"' || c == '\\') os << '\\';
+                os << c;
+            }
+            os << "\", \"trials\": " << r.trials << ", \"median_s\": " << r.median << ", \"p95_s\": " << r.p95
+               << ", \"mean_s\": " << r.mean << ", \"stddev_s\": " << r.stddev << ", \"min_s\": " << r.min;
+            if (r.hasCounters) {
+                os << ", \"cycles\": " << count(r.cycles) << ", \"instructions\": " << count(r.instructions)
+                   << ", \"cache_misses\": " << count(r.cacheMisses);
+            }
+            os << "}" << (i + 1 < collected.size() ? "," : "") << "\n";
+        }
+        os << "]\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+private:
+    static unsigned long long count(double value) {
+        return static_cast<unsigned long long>(value + 0.5);
+    }
+
+    BenchmarkResult summarize(const std::string& name, std::vector<double> samples) const {
+        std::sort(samples.begin(), samples.end());
+        size_t n = samples.size();
+        BenchmarkResult r;
+        r.name = name;
+        r.trials = static_cast<int>(n);
+        r.min = samples.front();
+        r.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+        r.p95 = samples[static_cast<size_t>(std::ceil(0.95 * n)) - 1];     // 最近秩法
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        r.mean = sum / n;
+        double sq = 0.0;
+        for (double s : samples) sq += (s - r.mean) * (s - r.mean);
+        r.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+        return r;
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "parallel_for.h"
+
+// 可复现的测试数据生成，供各实验的基准测试共用。
+// 所有数据都由显式给出的种子决定：同一种子在任何机器、任何线程数下生成完全相同的数据。
+
+// xoshiro256** 伪随机数发生器：周期 2^256-1，每个数只需几次移位与乘法，
+// 满足 UniformRandomBitGenerator，可直接交给 std::shuffle 等标准算法。
+// (seed, stream) 经 splitmix64 展开为初始状态，不同 stream 视为互不相关的序列
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        for (auto& word : state) word = splitmix64(x);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, 1) 上的均匀分布，取高 53 位
+    double nextDouble() {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    double uniform(double lo, double hi) {
+        return lo + (hi - lo) * nextDouble();
+    }
+
+    // [lo, hi] 上的均匀整数
+    long long uniformInt(long long lo, long long hi) {
+        unsigned long long span = static_cast<unsigned long long>(hi - lo) + 1;
+        if (span == 0) return static_cast<long long>((*this)());          // 整个 64 位范围
+        return lo + static_cast<long long>(((*this)() >> 11) % span);
+    }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+class DataGenerator {
+public:
+    static constexpr uint64_t DEFAULT_SEED = 2025;
+
+    // 数据的排列方式：随机、升序、降序
+    enum Order { RANDOM, SORTED, REVERSED };
+
+    // 生成 n 个元素，第 i 个为 make(rng, i)。输出按 BLOCK 个元素分块，
+    // 第 b 块使用 Xoshiro256(seed, b)，各块由 threads 个线程并行生成；
+    // 块的划分与线程数无关，因此结果只取决于 seed
+    template<typename T, typename Make>
+    static std::vector<T> generate(size_t n, uint64_t seed, Make make, unsigned threads = hardwareThreads()) {
+        std::vector<T> data(n);
+        const size_t blocks = (n + BLOCK - 1) / BLOCK;
+        parallelChunks(blocks, std::min<size_t>(threads, std::max<size_t>(blocks, 1)),
+                       [&](unsigned, size_t first, size_t last) {
+            for (size_t b = first; b < last; ++b) {
+                Xoshiro256 rng(seed, b);
+                const size_t end = std::min(n, (b + 1) * BLOCK);
+                for (size_t i = b * BLOCK; i < end; ++i) data[i] = make(rng, i);
+            }
+        });
+        return data;
+    }
+
+    static std::vector<double> uniformReals(size_t n, double lo, double hi, uint64_t seed = DEFAULT_SEED) {
+        return generate<double>(n, seed, [lo, hi](Xoshiro256& rng, size_t) { return rng.uniform(lo, hi); });
+    }
+
+    // 取值范围较小时即为大量重复的数据
+    static std::vector<int> uniformInts(size_t n, int lo, int hi, uint64_t seed = DEFAULT_SEED) {
+        return generate<int>(n, seed, [lo, hi](Xoshiro256& rng, size_t) {
+            return static_cast<int>(rng.uniformInt(lo, hi));
+        });
+    }
+
+    // 按 comp 重排为升序或降序(RANDOM 时保持原样)
+    template<typename T, typename Compare = std::less<T>>
+    static void arrange(std::vector<T>& data, Order order, Compare comp = Compare()) {
+        if (order == RANDOM) return;
+        std::sort(data.begin(), data.end(), comp);
+        if (order == REVERSED) std::reverse(data.begin(), data.end());
+    }
+
+private:
+    static constexpr size_t BLOCK = 1 << 16;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+// 自底向上的归并排序器，供 exp1(Complex) 与 exp4(BoundingBox) 共用。
+// 1. 先用插入排序把数据整理成长度为 RUN 的有序段；detectRuns 为真时改为先识别
+//    天然有序段(严格逆序段就地翻转)，不足 RUN 的再补齐，顺序/逆序输入接近线性；
+// 2. 再逐轮两两归并，在原数组与辅助缓冲区之间来回，不逐段拷贝；
+//    相邻两段本已有序时直接整段搬运。
+// 辅助缓冲区由排序器持有，同一个排序器多次排序时只在第一次分配。排序是稳定的。
+template<typename T>
+class MergeSorter {
+private:
+    static constexpr size_t RUN = 32;
+
+    std::vector<T> buffer;
+    std::vector<size_t> runs;      // 各有序段的边界: runs[k] .. runs[k+1]
+
+    template<typename Compare>
+    static void insertionSort(T* data, size_t begin, size_t sortedEnd, size_t end, Compare& comp) {
+        for (size_t i = sortedEnd; i < end; ++i) {
+            T item = std::move(data[i]);
+            size_t j = i;
+            while (j > begin && comp(item, data[j - 1])) {
+                data[j] = std::move(data[j - 1]);
+                j--;
+            }
+            data[j] = std::move(item);
+        }
+    }
+
+    template<typename Compare>
+    static void merge(const T* src, T* dst, size_t left, size_t mid, size_t right, Compare& comp) {
+        if (!comp(src[mid], src[mid - 1])) {
+            std::copy(src + left, src + right, dst + left);
+            return;
+        }
+        size_t i = left, j = mid, k = left;
+        while (i < mid && j < right) {
+            if (comp(src[j], src[i])) dst[k++] = src[j++];
+            else dst[k++] = src[i++];
+        }
+        while (i < mid) dst[k++] = src[i++];
+        while (j < right) dst[k++] = src[j++];
+    }
+
+public:
+    template<typename Compare = std::less<T>>
+    void sort(std::vector<T>& vec, Compare comp = Compare(), bool detectRuns = false) {
+        sort(vec.data(), vec.size(), comp, detectRuns);
+    }
+
+    // 对 data[0, n) 排序，供并行排序对各自的分段调用
+    template<typename Compare = std::less<T>>
+    void sort(T* data, size_t n, Compare comp = Compare(), bool detectRuns = false) {
+        if (n < 2) return;
+
+        runs.clear();
+        runs.push_back(0);
+        for (size_t begin = 0; begin < n; ) {
+            size_t end = begin + 1;
+            if (detectRuns) {
+                if (end < n && comp(data[end], data[begin])) {
+                    while (end < n && comp(data[end], data[end - 1])) end++;
+                    std::reverse(data + begin, data + end);
+                } else {
+                    while (end < n && !comp(data[end], data[end - 1])) end++;
+                }
+            }
+            if (end - begin < RUN) {
+                size_t forced = std::min(n, begin + RUN);
+                insertionSort(data, begin, end, forced, comp);
+                end = forced;
+            }
+            runs.push_back(end);
+            begin = end;
+        }
+
+        if (buffer.size() < n) buffer.resize(n);
+        T* src = data;
+        T* dst = buffer.data();
+        while (runs.size() > 2) {
+            size_t w = 1;
+            size_t k = 0;
+            for (; k + 2 < runs.size(); k += 2) {
+                merge(src, dst, runs[k], runs[k + 1], runs[k + 2], comp);
+                runs[w++] = runs[k + 2];
+            }
+            if (k + 1 < runs.size()) {      // 落单的最后一段原样搬过去
+                std::copy(src + runs[k], src + runs[k + 1], dst + runs[k]);
+                runs[w++] = runs[k + 1];
+            }
+            runs.resize(w);
+            std::swap(src, dst);
+        }
+        if (src != data) std::copy(src, src + n, data);
+    }
+};
+
+// 便捷接口：一次性排序
+template<typename T, typename Compare = std::less<T>>
+void bottomUpMergeSort(std::vector<T>& vec, Compare comp = Compare(), bool detectRuns = false) {
+    MergeSorter<T> sorter;
+    sorter.sort(vec, comp, detectRuns);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+
+// 把 [0, n) 均分为 threads 段，每段在一个线程上执行 body(t, begin, end)；
+// 第 0 段在调用线程上执行
+template<typename Body>
+void parallelChunks(size_t n, unsigned threads, Body body) {
+    if (threads < 1) threads = 1;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([&body, n, threads, t] {
+            body(t, n * t / threads, n * (t + 1) / threads);
+        });
+    }
+    body(0u, size_t(0), n / threads);
+    for (auto& worker : workers) worker.join();
+}
+
+inline unsigned hardwareThreads() {
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+}
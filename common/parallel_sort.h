@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "merge_sort.h"
+#include "parallel_for.h"
+
+// 多线程稳定排序。两种算法都只依赖比较器，且都是稳定的：
+// 比较器是严格弱序时，结果与串行稳定排序(MergeSorter)逐元素相同，与线程数无关。
+class ParallelSort {
+public:
+    // 数据量低于该值时直接串行排序，线程启动的开销不划算
+    static constexpr size_t SERIAL_THRESHOLD = 1 << 14;
+
+    template<typename Body>
+    static void forChunks(size_t n, unsigned threads, Body body) {
+        parallelChunks(n, threads, body);
+    }
+
+    // 并行归并排序：各线程先串行排序自己的分段，再逐轮两两归并；
+    // 每轮把所有待归并的输出按归并路径(merge path)切成 threads 份并行写出
+    template<typename T, typename Compare = std::less<T>>
+    static void mergeSort(std::vector<T>& vec, Compare comp = Compare(), unsigned threads = defaultThreads()) {
+        const size_t n = vec.size();
+        if (threads <= 1 || n < SERIAL_THRESHOLD) {
+            MergeSorter<T>().sort(vec, comp);
+            return;
+        }
+
+        std::vector<size_t> runs(threads + 1);
+        for (unsigned t = 0; t <= threads; ++t) runs[t] = n * t / threads;
+        forChunks(threads, threads, [&](unsigned, size_t first, size_t last) {
+            MergeSorter<T> sorter;
+            for (size_t r = first; r < last; ++r) sorter.sort(vec.data() + runs[r], runs[r + 1] - runs[r], comp);
+        });
+
+        std::vector<T> buffer(n);
+        T* src = vec.data();
+        T* dst = buffer.data();
+        while (runs.size() > 2) {
+            // 输出区间 [k0, k1) 的一段只属于一对相邻的段(或落单的最后一段)
+            forChunks(n, threads, [&](unsigned, size_t k0, size_t k1) {
+                while (k0 < k1) {
+                    size_t pair = (std::upper_bound(runs.begin(), runs.end(), k0) - runs.begin() - 1) & ~size_t(1);
+                    size_t left = runs[pair], mid = runs[pair + 1];
+                    size_t right = pair + 2 < runs.size() ? runs[pair + 2] : mid;
+                    size_t end = std::min(k1, right);
+                    mergeSlice(src + left, mid - left, src + mid, right - mid,
+                               dst + left, k0 - left, end - left, comp);
+                    k0 = end;
+                }
+            });
+            size_t w = 1;
+            for (size_t k = 2; k < runs.size(); k += 2) runs[w++] = runs[k];
+            if (runs.size() % 2 == 0) runs[w++] = runs.back();
+            runs.resize(w);
+            std::swap(src, dst);
+        }
+        if (src != vec.data()) vec.swap(buffer);
+    }
+
+    // 并行样本排序：按等距采样选出 threads-1 个分割点，各线程统计自己分段中
+    // 每个桶的元素数，按 (桶, 线程) 的次序算出写入位置后分散到辅助数组，
+    // 最后各桶独立串行排序。采样位置固定，结果不依赖随机数
+    template<typename T, typename Compare = std::less<T>>
+    static void sampleSort(std::vector<T>& vec, Compare comp = Compare(), unsigned threads = defaultThreads()) {
+        const size_t n = vec.size();
+        if (threads <= 1 || n < SERIAL_THRESHOLD) {
+            MergeSorter<T>().sort(vec, comp);
+            return;
+        }
+
+        const size_t buckets = threads;
+        const size_t sampleCount = OVERSAMPLING * buckets;
+        std::vector<T> samples;
+        samples.reserve(sampleCount);
+        for (size_t s = 0; s < sampleCount; ++s) samples.push_back(vec[(2 * s + 1) * n / (2 * sampleCount)]);
+        MergeSorter<T>().sort(samples, comp);
+        std::vector<T> splitters;
+        for (size_t b = 1; b < buckets; ++b) splitters.push_back(samples[b * sampleCount / buckets]);
+
+        std::vector<unsigned> bucketOf(n);
+        std::vector<size_t> counts(threads * buckets, 0);
+        forChunks(n, threads, [&](unsigned t, size_t begin, size_t end) {
+            size_t* count = &counts[t * buckets];
+            for (size_t i = begin; i < end; ++i) {
+                unsigned b = std::upper_bound(splitters.begin(), splitters.end(), vec[i], comp) - splitters.begin();
+                bucketOf[i] = b;
+                count[b]++;
+            }
+        });
+
+        std::vector<size_t> bucketStart(buckets + 1, 0);
+        std::vector<size_t> offsets(threads * buckets);
+        size_t position = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            bucketStart[b] = position;
+            for (unsigned t = 0; t < threads; ++t) {
+                offsets[t * buckets + b] = position;
+                position += counts[t * buckets + b];
+            }
+        }
+        bucketStart[buckets] = n;
+
+        std::vector<T> buffer(n);
+        forChunks(n, threads, [&](unsigned t, size_t begin, size_t end) {
+            size_t* offset = &offsets[t * buckets];
+            for (size_t i = begin; i < end; ++i) buffer[offset[bucketOf[i]]++] = vec[i];
+        });
+        forChunks(buckets, threads, [&](unsigned, size_t first, size_t last) {
+            MergeSorter<T> sorter;
+            for (size_t b = first; b < last; ++b) {
+                sorter.sort(buffer.data() + bucketStart[b], bucketStart[b + 1] - bucketStart[b], comp);
+            }
+        });
+        vec.swap(buffer);
+    }
+
+    static unsigned defaultThreads() {
+        return hardwareThreads();
+    }
+
+private:
+    static constexpr size_t OVERSAMPLING = 64;
+
+    // 稳定归并 a[0, na) 与 b[0, nb) 时，输出前 k 个元素中来自 a 的个数
+    template<typename T, typename Compare>
+    static size_t coRank(const T* a, size_t na, const T* b, size_t nb, size_t k, Compare& comp) {
+        size_t lo = k > nb ? k - nb : 0;
+        size_t hi = std::min(k, na);
+        while (lo < hi) {
+            size_t i = lo + (hi - lo) / 2;
+            size_t j = k - i;
+            if (j > 0 && !comp(b[j - 1], a[i])) lo = i + 1;
+            else hi = i;
+        }
+        return lo;
+    }
+
+    // 只写出归并结果的第 [k0, k1) 个元素
+    template<typename T, typename Compare>
+    static void mergeSlice(const T* a, size_t na, const T* b, size_t nb,
+                           T* out, size_t k0, size_t k1, Compare& comp) {
+        size_t i = coRank(a, na, b, nb, k0, comp), j = k0 - i;
+        for (size_t k = k0; k < k1; ++k) {
+            if (j < nb && (i >= na || comp(b[j], a[i]))) out[k] = b[j++];
+            else out[k] = a[i++];
+        }
+    }
+};
@@ -1,29 +1,201 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <array>
+#include <string_view>
+#include <charconv>
 #include <cmath>
 #include <cctype>
 #include <stdexcept>
 #include <map>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <tuple>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <fstream>
+
+// 分配计数：替换全局 operator new，用于验证求值路径在稳态下不分配堆内存
+thread_local long long allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"   // operator new 已改为 malloc，与 free 配对
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+class FunctionEvaluator {
+public:
+    enum Function { SIN, COS, TAN, LOG, LN, SQRT, ABS, NUM_FUNCTIONS };
+    static constexpr const char* FUNCTION_NAMES[NUM_FUNCTIONS] = {
+        "sin", "cos", "tan", "log", "ln", "sqrt", "abs"
+    };
+
+    // 函数名 -> 编号，未知函数返回 -1
+    static int functionIndex(std::string_view name) {
+        for (int i = 0; i < NUM_FUNCTIONS; ++i) {
+            if (name == FUNCTION_NAMES[i]) return i;
+        }
+        return -1;
+    }
+
+    static double applyFunction(Function func, double x) {
+        switch (func) {
+            case SIN: return std::sin(x * M_PI / 180);
+            case COS: return std::cos(x * M_PI / 180);
+            case TAN: return std::tan(x * M_PI / 180);
+            case LOG:
+                if (x <= 0) throw std::runtime_error("对数参数需为正数");
+                return std::log10(x);
+            case LN:
+                if (x <= 0) throw std::runtime_error("自然对数参数需为正数");
+                return std::log(x);
+            case SQRT:
+                if (x < 0) throw std::runtime_error("平方根参数需为非负数");
+                return std::sqrt(x);
+            case ABS: return std::abs(x);
+            default: throw std::runtime_error("无效函数");
+        }
+    }
+
+    // 对一整块数据逐元素应用函数：定义域先整体检查，再跑不含分支的紧凑循环
+    static void applyFunctionBlock(Function func, const double* in, double* out, size_t n) {
+        switch (func) {
+            case SIN: for (size_t k = 0; k < n; ++k) out[k] = std::sin(in[k] * M_PI / 180); break;
+            case COS: for (size_t k = 0; k < n; ++k) out[k] = std::cos(in[k] * M_PI / 180); break;
+            case TAN: for (size_t k = 0; k < n; ++k) out[k] = std::tan(in[k] * M_PI / 180); break;
+            case LOG:
+                if (anyBelow(in, n, 0.0, true)) throw std::runtime_error("对数参数需为正数");
+                for (size_t k = 0; k < n; ++k) out[k] = std::log10(in[k]);
+                break;
+            case LN:
+                if (anyBelow(in, n, 0.0, true)) throw std::runtime_error("自然对数参数需为正数");
+                for (size_t k = 0; k < n; ++k) out[k] = std::log(in[k]);
+                break;
+            case SQRT:
+                if (anyBelow(in, n, 0.0, false)) throw std::runtime_error("平方根参数需为非负数");
+                for (size_t k = 0; k < n; ++k) out[k] = std::sqrt(in[k]);
+                break;
+            case ABS: for (size_t k = 0; k < n; ++k) out[k] = std::abs(in[k]); break;
+            default: throw std::runtime_error("无效函数");
+        }
+    }
+
+    static double evaluateFunction(const std::string& func, double arg) {
+        int index = functionIndex(func);
+        if (index < 0) throw std::runtime_error("未知函数: " + func);
+        return applyFunction(static_cast<Function>(index), arg);
+    }
+    
+    // 支持函数调用的表达式求值，函数已由 Calculator 的单遍扫描直接识别
+    static double evaluateExtended(const std::string& expr);
+
+private:
+    static bool anyBelow(const double* in, size_t n, double bound, bool inclusive) {
+        bool found = false;
+        if (inclusive) {
+            for (size_t k = 0; k < n; ++k) found |= (in[k] <= bound);
+        } else {
+            for (size_t k = 0; k < n; ++k) found |= (in[k] < bound);
+        }
+        return found;
+    }
+};
+
+// 编译期生成的阶乘表: FACTORIAL_TABLE[n] = n!，n <= 170
+constexpr std::array<double, 171> makeFactorialTable() {
+    std::array<double, 171> table{};
+    table[0] = 1;
+    for (int i = 1; i < 171; ++i) table[i] = table[i - 1] * i;
+    return table;
+}
 
 class Calculator {
+    friend class CompiledExpression;
+
+private:
+    static constexpr int MAX_FACTORIAL = 170;
+    static constexpr std::array<double, MAX_FACTORIAL + 1> FACTORIAL_TABLE = makeFactorialTable();
+    static constexpr double MAX_FAST_EXPONENT = 64;
+
+    // 非整数阶乘是否按 Gamma 函数 n! = Γ(n+1) 计算；关闭时与原先一样报错
+    static inline std::atomic<bool> gammaFactorial{false};
+
+public:
+    static void setGammaFactorial(bool enabled) { gammaFactorial = enabled; }
+
+    // 整数阶乘直接查表；超过 170! 的结果已超出 double 范围
+    static double factorial(double n) {
+        if (n >= 0 && n == std::floor(n)) {
+            return n <= MAX_FACTORIAL ? FACTORIAL_TABLE[static_cast<int>(n)] : HUGE_VAL;
+        }
+        if (gammaFactorial && !(n < 0 && n == std::floor(n))) {
+            return std::tgamma(n + 1);
+        }
+        throw std::runtime_error("阶乘需要非负整数");
+    }
+
+    // 整数指数走平方-乘法快速路径，其余情形交给 std::pow
+    static double power(double base, double exponent) {
+        if (exponent == std::floor(exponent) && std::abs(exponent) <= MAX_FAST_EXPONENT) {
+            long long n = static_cast<long long>(std::abs(exponent));
+            double result = 1;
+            while (n > 0) {
+                if (n & 1) result *= base;
+                base *= base;
+                n >>= 1;
+            }
+            return exponent < 0 ? 1 / result : result;
+        }
+        return std::pow(base, exponent);
+    }
+
 private:
-    enum Operator { ADD, SUB, MUL, DIV, POW, FAC, L_P, R_P, EOE };
-    static constexpr int NUM_OPERATORS = 9;
-    static constexpr char OPERATOR_CHARS[NUM_OPERATORS] = {'+', '-', '*', '/', '^', '!', '(', ')', '\0'};
+    // FUN(函数调用)与 NEG(一元负号)没有对应字符，由扫描器根据上下文产生
+    enum Operator { ADD, SUB, MUL, DIV, POW, FAC, L_P, R_P, EOE, FUN, NEG };
+    static constexpr int NUM_OPERATORS = 11;
+    static constexpr int NUM_CHAR_OPERATORS = 9;
+    static constexpr char OPERATOR_CHARS[NUM_CHAR_OPERATORS] = {'+', '-', '*', '/', '^', '!', '(', ')', '\0'};
     
     // 运算符优先级表 [栈顶][当前]
     static constexpr char PRIORITY_TABLE[NUM_OPERATORS][NUM_OPERATORS] = {
-        {'>', '>', '<', '<', '<', '<', '<', '>', '>'}, // +
-        {'>', '>', '<', '<', '<', '<', '<', '>', '>'}, // -
-        {'>', '>', '>', '>', '<', '<', '<', '>', '>'}, // *
-        {'>', '>', '>', '>', '<', '<', '<', '>', '>'}, // /
-        {'>', '>', '>', '>', '>', '<', '<', '>', '>'}, // ^
-        {'>', '>', '>', '>', '>', '>', ' ', '>', '>'}, // !
-        {'<', '<', '<', '<', '<', '<', '<', '=', ' '}, // (
-        {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '}, // )
-        {'<', '<', '<', '<', '<', '<', '<', ' ', '='}  // \0
+        {'>', '>', '<', '<', '<', '<', '<', '>', '>', '<', '<'}, // +
+        {'>', '>', '<', '<', '<', '<', '<', '>', '>', '<', '<'}, // -
+        {'>', '>', '>', '>', '<', '<', '<', '>', '>', '<', '<'}, // *
+        {'>', '>', '>', '>', '<', '<', '<', '>', '>', '<', '<'}, // /
+        {'>', '>', '>', '>', '>', '<', '<', '>', '>', '<', '<'}, // ^
+        {'>', '>', '>', '>', '>', '>', ' ', '>', '>', ' ', ' '}, // !
+        {'<', '<', '<', '<', '<', '<', '<', '=', ' ', '<', '<'}, // (
+        {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '}, // )
+        {'<', '<', '<', '<', '<', '<', '<', ' ', '=', '<', '<'}, // \0
+        {'>', '>', '>', '>', '>', '>', '<', '>', '>', ' ', ' '}, // 函数
+        {'>', '>', '>', '>', '>', '>', '<', '>', '>', '<', '<'}  // 负号
     };
 
     template<typename T>
@@ -42,10 +214,23 @@ private:
             if (empty()) throw std::runtime_error("栈空");
             data.pop_back();
         }
+        void clear() { data.clear(); }     // 保留容量，供下次求值复用
     };
 
+    // 每个线程一份的求值工作区：栈在多次求值间复用，稳态下不再分配堆内存
+    struct Workspace {
+        Stack<Operator> operators;
+        Stack<int> functions;
+        Stack<double> operands;
+    };
+
+    static Workspace& workspace() {
+        thread_local Workspace ws;
+        return ws;
+    }
+
     static Operator charToOperator(char c) {
-        for (int i = 0; i < NUM_OPERATORS; ++i) {
+        for (int i = 0; i < NUM_CHAR_OPERATORS; ++i) {
             if (c == OPERATOR_CHARS[i]) return static_cast<Operator>(i);
         }
         return EOE;
@@ -55,15 +240,6 @@ private:
         return PRIORITY_TABLE[op1][op2];
     }
 
-    static double factorial(double n) {
-        if (n < 0 || n != static_cast<int>(n)) {
-            throw std::runtime_error("阶乘需要非负整数");
-        }
-        double result = 1;
-        for (int i = 2; i <= static_cast<int>(n); ++i) result *= i;
-        return result;
-    }
-
     static double calculateBinary(double a, Operator op, double b) {
         switch (op) {
             case ADD: return a + b;
@@ -72,13 +248,14 @@ private:
             case DIV: 
                 if (b == 0) throw std::runtime_error("除零错误");
                 return a / b;
-            case POW: return std::pow(a, b);
+            case POW: return power(a, b);
             default: throw std::runtime_error("无效二元运算");
         }
     }
 
     static double calculateUnary(Operator op, double a) {
         if (op == FAC) return factorial(a);
+        if (op == NEG) return -a;
         throw std::runtime_error("无效一元运算");
     }
 
@@ -86,157 +263,801 @@ private:
         return std::isdigit(c) || c == '.';
     }
 
-    static std::pair<double, int> extractNumber(const std::string& expr, int start) {
-        std::string numStr;
-        int i = start;
-        
-        // 处理负号
-        if (i < expr.length() && expr[i] == '-' && 
-            (i == 0 || expr[i-1] == '(' || std::string("+-*/^").find(expr[i-1]) != std::string::npos)) {
-            numStr += expr[i++];
-        }
+    static bool isIdentifierChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    static size_t skipSpaces(std::string_view expr, size_t i) {
+        while (i < expr.length() && std::isspace(static_cast<unsigned char>(expr[i]))) i++;
+        return i;
+    }
+
+    // 从 start 开始读取一个(可带负号的)数字，返回数值和结束位置
+    static std::pair<double, size_t> extractNumber(std::string_view expr, size_t start) {
+        size_t i = start;
+        if (i < expr.length() && expr[i] == '-') i++;
+        while (i < expr.length() && isDigit(expr[i])) i++;
         
-        while (i < expr.length() && (isDigit(expr[i]))) {
-            numStr += expr[i++];
+        double value;
+        auto [ptr, ec] = std::from_chars(expr.data() + start, expr.data() + i, value);
+        if (ec != std::errc() || ptr == expr.data() + start) {
+            throw std::runtime_error("数字格式错误");
         }
-        
-        if (numStr.empty()) throw std::runtime_error("数字格式错误");
-        return {std::stod(numStr), i};
+        return {value, i};
     }
 
-public:
-    static double evaluate(const std::string& expression) {
-        if (expression.empty()) return 0.0;
-        
-        std::string expr = "\0" + expression + "\0";
-        Stack<double> operands;
-        Stack<Operator> operators;
-        operators.push(charToOperator('\0'));
-        
-        int i = 1;
-        while (i < expr.length()) {
-            if (isDigit(expr[i]) || 
-                (expr[i] == '-' && (i == 1 || std::string("\0(+-*/^").find(expr[i-1]) != std::string::npos))) {
-                
+    // 单遍扫描的运算符优先级分析：数字、标识符、函数名与运算符在同一趟中识别，
+    // 函数调用与一元负号作为一等的前缀运算符参与优先级比较，整体 O(n)。
+    // Handler 决定遇到操作数、归约运算符时做什么——直接计算(evaluate)或发射指令(compile)
+    template<typename Handler>
+    static void parse(std::string_view expr, Handler& handler) {
+        Stack<Operator>& operators = workspace().operators;
+        Stack<int>& functions = workspace().functions;     // 与运算符栈中的每个 FUN 一一对应
+        operators.clear();
+        functions.clear();
+        operators.push(EOE);
+        bool expectOperand = true;
+        size_t i = 0;
+
+        while (true) {
+            i = skipSpaces(expr, i);
+            char c = i < expr.length() ? expr[i] : '\0';
+            char next = i + 1 < expr.length() ? expr[i + 1] : '\0';
+
+            if (expectOperand && (isDigit(c) || (c == '-' && isDigit(next)))) {
                 auto [num, nextPos] = extractNumber(expr, i);
-                operands.push(num);
+                handler.pushNumber(num);
                 i = nextPos;
+                expectOperand = false;
+                continue;
+            }
+
+            Operator currOp;
+            size_t tokenEnd = i + 1;
+            int func = -1;
+            if (expectOperand && std::isalpha(static_cast<unsigned char>(c))) {
+                size_t end = i;
+                while (end < expr.length() && isIdentifierChar(expr[end])) end++;
+                std::string_view name = expr.substr(i, end - i);
+                size_t paren = skipSpaces(expr, end);
+                if (paren >= expr.length() || expr[paren] != '(') {
+                    handler.pushVariable(name);
+                    i = end;
+                    expectOperand = false;
+                    continue;
+                }
+                func = FunctionEvaluator::functionIndex(name);
+                if (func < 0) throw std::runtime_error("未知函数: " + std::string(name));
+                currOp = FUN;
+                tokenEnd = paren;   // 左括号作为下一个记号正常处理
+            } else if (expectOperand && c == '-') {
+                currOp = NEG;
             } else {
-                Operator currOp = charToOperator(expr[i]);
-                if (currOp == EOE) break;
-                
-                char priority = getPriority(operators.top(), currOp);
-                
-                if (priority == '<') {
-                    operators.push(currOp);
-                    i++;
-                } else if (priority == '=') {
-                    operators.pop();
-                    i++;
-                } else if (priority == '>') {
-                    processOperation(operands, operators);
+                currOp = charToOperator(c);
+                if (currOp == EOE && c != '\0') {
+                    throw std::runtime_error(std::string("非法字符: ") + c);
+                }
+            }
+
+            char priority;
+            while ((priority = getPriority(operators.top(), currOp)) == '>') {
+                Operator op = operators.top();
+                operators.pop();
+                if (op == FUN) {
+                    handler.applyFunction(functions.top());
+                    functions.pop();
                 } else {
-                    throw std::runtime_error("优先级错误");
+                    handler.applyOperator(op);
                 }
             }
+
+            if (priority == '<') {
+                operators.push(currOp);
+                if (currOp == FUN) functions.push(func);
+                expectOperand = (currOp != FAC);
+                i = tokenEnd;
+            } else if (priority == '=') {
+                operators.pop();
+                if (currOp == EOE) break;
+                expectOperand = false;
+                i = tokenEnd;
+            } else {
+                throw std::runtime_error("优先级错误");
+            }
         }
-        
-        while (operators.top() != charToOperator('\0')) {
-            processOperation(operands, operators);
-        }
-        
-        if (operands.size() != 1) throw std::runtime_error("表达式无效");
-        return operands.top();
     }
 
-private:
-    static void processOperation(Stack<double>& operands, Stack<Operator>& operators) {
-        Operator op = operators.top();
-        operators.pop();
-        
-        if (op == FAC) {
-            if (operands.empty()) throw std::runtime_error("阶乘操作数不足");
-            double a = operands.top(); operands.pop();
-            operands.push(calculateUnary(op, a));
-        } else {
-            if (operands.size() < 2) throw std::runtime_error("操作数不足");
-            double b = operands.top(); operands.pop();
+    // 直接求值的 Handler
+    struct Evaluator {
+        Stack<double>& operands;
+
+        void pushNumber(double value) { operands.push(value); }
+
+        void pushVariable(std::string_view name) {
+            throw std::runtime_error("未知变量: " + std::string(name));
+        }
+
+        void applyFunction(int func) {
+            if (operands.empty()) throw std::runtime_error("函数操作数不足");
             double a = operands.top(); operands.pop();
-            operands.push(calculateBinary(a, op, b));
+            operands.push(FunctionEvaluator::applyFunction(static_cast<FunctionEvaluator::Function>(func), a));
         }
+
+        void applyOperator(Operator op) {
+            if (op == FAC || op == NEG) {
+                if (operands.empty()) throw std::runtime_error(op == FAC ? "阶乘操作数不足" : "操作数不足");
+                double a = operands.top(); operands.pop();
+                operands.push(calculateUnary(op, a));
+            } else {
+                if (operands.size() < 2) throw std::runtime_error("操作数不足");
+                double b = operands.top(); operands.pop();
+                double a = operands.top(); operands.pop();
+                operands.push(calculateBinary(a, op, b));
+            }
+        }
+    };
+
+public:
+    // 直接在调用方的字符串上扫描，不拷贝输入
+    static double evaluate(std::string_view expression) {
+        if (expression.empty()) return 0.0;
+        
+        Evaluator evaluator{workspace().operands};
+        evaluator.operands.clear();
+        parse(expression, evaluator);
+        
+        if (evaluator.operands.size() != 1) throw std::runtime_error("表达式无效");
+        return evaluator.operands.top();
     }
 };
 
-class FunctionEvaluator {
+inline double FunctionEvaluator::evaluateExtended(const std::string& expr) {
+    return Calculator::evaluate(expr);
+}
+
+// 编译型表达式：一次解析为后缀字节码，之后可对不同的变量取值反复求值
+// 求值过程不再分词、不建栈、不做字符串替换，也不分配堆内存
+class CompiledExpression {
 public:
-    static double evaluateFunction(const std::string& func, double arg) {
-        static const std::map<std::string, std::function<double(double)>> functions = {
-            {"sin", [](double x) { return std::sin(x * M_PI / 180); }},
-            {"cos", [](double x) { return std::cos(x * M_PI / 180); }},
-            {"tan", [](double x) { return std::tan(x * M_PI / 180); }},
-            {"log", [](double x) { 
-                if (x <= 0) throw std::runtime_error("对数参数需为正数");
-                return std::log10(x);
-            }},
-            {"ln", [](double x) { 
-                if (x <= 0) throw std::runtime_error("自然对数参数需为正数");
-                return std::log(x);
-            }},
-            {"sqrt", [](double x) { 
-                if (x < 0) throw std::runtime_error("平方根参数需为非负数");
-                return std::sqrt(x);
-            }},
-            {"abs", [](double x) { return std::abs(x); }}
-        };
-        
-        auto it = functions.find(func);
-        if (it == functions.end()) throw std::runtime_error("未知函数: " + func);
-        return it->second(arg);
+    enum OpCode : unsigned char { PUSH_CONST, PUSH_VAR, ADD, SUB, MUL, DIV, POW, FAC, NEG, CALL, STORE, LOAD };
+
+    struct Instruction {
+        OpCode op;
+        int arg;        // PUSH_VAR: 变量下标; CALL: 函数编号; STORE/LOAD: 临时槽位
+        double value;   // PUSH_CONST: 常量值
+    };
+
+    static CompiledExpression compile(const std::string& expression,
+                                      const std::vector<std::string>& variables = {}) {
+        CompiledExpression program;
+        program.numVariables = variables.size();
+        if (expression.empty()) {
+            program.emit({PUSH_CONST, 0, 0.0});
+            return program;
+        }
+
+        // 与 Calculator::evaluate 共用同一遍扫描，只是把“计算”换成“发射指令”
+        Emitter emitter{program, variables};
+        Calculator::parse(expression, emitter);
+
+        if (program.depth != 1) throw std::runtime_error("表达式无效");
+        return program;
     }
-    
-    static std::string replaceFunctions(const std::string& expr) {
-        std::string result = expr;
-        std::vector<std::string> funcs = {"sin", "cos", "tan", "log", "ln", "sqrt", "abs"};
-        
-        for (const auto& func : funcs) {
-            size_t pos = 0;
-            while ((pos = result.find(func, pos)) != std::string::npos) {
-                size_t end = pos + func.length();
-                if (end < result.length() && result[end] == '(') {
-                    size_t start = pos;
-                    int parenCount = 0;
-                    size_t i = end;
-                    
-                    while (i < result.length()) {
-                        if (result[i] == '(') parenCount++;
-                        else if (result[i] == ')') {
-                            if (--parenCount == 0) {
-                                std::string arg = result.substr(end + 1, i - end - 1);
-                                try {
-                                    double value = evaluateExtended(arg);
-                                    result.replace(start, i - start + 1, std::to_string(value));
-                                    break;
-                                } catch (...) {
-                                    pos = i + 1;
-                                    break;
-                                }
+
+    double eval(const double* vars = nullptr) const {
+        // 运算栈与公共子表达式的临时槽位共用一块缓冲区
+        double inlineStack[INLINE_STACK_SIZE];
+        double* stack = inlineStack;
+        if (maxDepth + numTemps > INLINE_STACK_SIZE) stack = deepStack(maxDepth + numTemps);
+        double* temps = stack + maxDepth;
+        stack[0] = 0.0;     // 空程序(默认构造的对象)求值为 0
+
+        int sp = -1;
+        for (const Instruction& ins : code) {
+            switch (ins.op) {
+                case PUSH_CONST: stack[++sp] = ins.value; break;
+                case PUSH_VAR:   stack[++sp] = vars[ins.arg]; break;
+                case ADD: sp--; stack[sp] += stack[sp + 1]; break;
+                case SUB: sp--; stack[sp] -= stack[sp + 1]; break;
+                case MUL: sp--; stack[sp] *= stack[sp + 1]; break;
+                case DIV:
+                    if (stack[sp] == 0) throw std::runtime_error("除零错误");
+                    sp--; stack[sp] /= stack[sp + 1];
+                    break;
+                case POW: sp--; stack[sp] = Calculator::power(stack[sp], stack[sp + 1]); break;
+                case FAC: stack[sp] = Calculator::factorial(stack[sp]); break;
+                case NEG: stack[sp] = -stack[sp]; break;
+                case CALL:
+                    stack[sp] = FunctionEvaluator::applyFunction(
+                        static_cast<FunctionEvaluator::Function>(ins.arg), stack[sp]);
+                    break;
+                case STORE: temps[ins.arg] = stack[sp]; break;
+                case LOAD:  stack[++sp] = temps[ins.arg]; break;
+            }
+        }
+        return stack[0];
+    }
+
+    // 列式批量求值：columns[v] 指向第 v 个变量的 n 个取值，结果写入 out
+    // 每条指令一次处理 BATCH_BLOCK 行，指令分派的开销被整块数据摊薄，
+    // 内层循环只剩逐元素运算，编译器可以直接向量化
+    static void evalBatch(const CompiledExpression& program, const double* const* columns,
+                          size_t n, double* out) {
+        if (program.code.empty()) {     // 空程序(默认构造的对象)与 eval 一致，求值为 0
+            std::fill(out, out + n, 0.0);
+            return;
+        }
+        const int depth = program.maxDepth;
+        std::vector<double> scratch(static_cast<size_t>(depth) * BATCH_BLOCK);
+        std::vector<const double*> slots(depth);
+        std::vector<double> temps(static_cast<size_t>(program.numTemps) * BATCH_BLOCK);
+
+        for (size_t base = 0; base < n; base += BATCH_BLOCK) {
+            const size_t m = std::min(BATCH_BLOCK, n - base);
+            int sp = -1;
+
+            for (const Instruction& ins : program.code) {
+                switch (ins.op) {
+                    case PUSH_CONST: {
+                        double* dst = &scratch[++sp * BATCH_BLOCK];
+                        for (size_t k = 0; k < m; ++k) dst[k] = ins.value;
+                        slots[sp] = dst;
+                        break;
+                    }
+                    case PUSH_VAR:
+                        slots[++sp] = columns[ins.arg] + base;   // 直接引用输入列，不拷贝
+                        break;
+                    case STORE:
+                        std::copy(slots[sp], slots[sp] + m, &temps[ins.arg * BATCH_BLOCK]);
+                        break;
+                    case LOAD:
+                        slots[++sp] = &temps[ins.arg * BATCH_BLOCK];
+                        break;
+                    case NEG: case FAC: case CALL: {
+                        const double* a = slots[sp];
+                        double* dst = &scratch[sp * BATCH_BLOCK];
+                        if (ins.op == NEG) {
+                            for (size_t k = 0; k < m; ++k) dst[k] = -a[k];
+                        } else if (ins.op == FAC) {
+                            for (size_t k = 0; k < m; ++k) dst[k] = Calculator::factorial(a[k]);
+                        } else {
+                            FunctionEvaluator::applyFunctionBlock(
+                                static_cast<FunctionEvaluator::Function>(ins.arg), a, dst, m);
+                        }
+                        slots[sp] = dst;
+                        break;
+                    }
+                    default: {
+                        const double* a = slots[sp - 1];
+                        const double* b = slots[sp];
+                        double* dst = &scratch[(sp - 1) * BATCH_BLOCK];
+                        switch (ins.op) {
+                            case ADD: for (size_t k = 0; k < m; ++k) dst[k] = a[k] + b[k]; break;
+                            case SUB: for (size_t k = 0; k < m; ++k) dst[k] = a[k] - b[k]; break;
+                            case MUL: for (size_t k = 0; k < m; ++k) dst[k] = a[k] * b[k]; break;
+                            case DIV: {
+                                bool zero = false;
+                                for (size_t k = 0; k < m; ++k) zero |= (b[k] == 0);
+                                if (zero) throw std::runtime_error("除零错误");
+                                for (size_t k = 0; k < m; ++k) dst[k] = a[k] / b[k];
+                                break;
                             }
+                            case POW: for (size_t k = 0; k < m; ++k) dst[k] = Calculator::power(a[k], b[k]); break;
+                            default: throw std::runtime_error("无效二元运算");
                         }
-                        i++;
+                        slots[--sp] = dst;
                     }
-                } else {
-                    pos++;
+                }
+            }
+
+            std::copy(slots[0], slots[0] + m, out + base);
+        }
+    }
+
+    // 优化：折叠常量子树、合并相同子表达式、把小整数次幂改写为乘法。
+    // 先把后缀程序还原为表达式 DAG(构建时即做折叠与哈希合并)，再重新生成指令，
+    // 被多次引用的结点只计算一次，经 STORE/LOAD 临时槽位复用
+    CompiledExpression optimized() const {
+        std::vector<Node> nodes;
+        NodeIndex index;
+        std::vector<int> stack;
+        std::vector<int> tempNodes(numTemps, -1);
+
+        for (const Instruction& ins : code) {
+            switch (ins.op) {
+                case PUSH_CONST: case PUSH_VAR:
+                    stack.push_back(makeNode(nodes, index, ins, -1, -1));
+                    break;
+                case STORE:
+                    tempNodes[ins.arg] = stack.back();
+                    break;
+                case LOAD:
+                    stack.push_back(tempNodes[ins.arg]);
+                    break;
+                case FAC: case NEG: case CALL: {
+                    int a = stack.back(); stack.pop_back();
+                    stack.push_back(makeNode(nodes, index, ins, a, -1));
+                    break;
+                }
+                default: {
+                    int b = stack.back(); stack.pop_back();
+                    int a = stack.back(); stack.pop_back();
+                    stack.push_back(makeNode(nodes, index, ins, a, b));
+                }
+            }
+        }
+
+        // 统计引用次数，引用多于一次的结点分配临时槽位
+        std::vector<int> uses(nodes.size(), 0);
+        std::vector<int> slot(nodes.size(), -1);
+        std::vector<bool> reachable(nodes.size(), false);
+        reachable[stack.back()] = true;
+        for (int id = nodes.size() - 1; id >= 0; --id) {
+            if (!reachable[id]) continue;
+            for (int child : {nodes[id].left, nodes[id].right}) {
+                if (child < 0) continue;
+                uses[child]++;
+                reachable[child] = true;
+            }
+        }
+
+        CompiledExpression result;
+        result.numVariables = numVariables;
+        // 非递归后序遍历，避免深层嵌套的表达式耗尽调用栈
+        std::vector<std::pair<int, bool>> work = {{stack.back(), false}};
+        while (!work.empty()) {
+            auto [id, expanded] = work.back();
+            work.pop_back();
+            const Node& node = nodes[id];
+            if (slot[id] >= 0) {
+                result.emit({LOAD, slot[id], 0.0});
+            } else if (!expanded && node.left >= 0) {
+                work.push_back({id, true});
+                if (node.right >= 0) work.push_back({node.right, false});
+                work.push_back({node.left, false});
+            } else {
+                result.emit({node.op, node.arg, node.value});
+                if (uses[id] > 1 && node.left >= 0) {
+                    slot[id] = result.numTemps++;
+                    result.emit({STORE, slot[id], 0.0});
                 }
             }
         }
         return result;
     }
-    
-    static double evaluateExtended(const std::string& expr) {
-        return Calculator::evaluate(replaceFunctions(expr));
+
+    const std::vector<Instruction>& instructions() const { return code; }
+    int size() const { return code.size(); }
+    int stackDepth() const { return maxDepth; }
+    int variableCount() const { return numVariables; }
+    int tempCount() const { return numTemps; }
+
+private:
+    static constexpr int INLINE_STACK_SIZE = 64;
+    static constexpr size_t BATCH_BLOCK = 256;
+
+    // 超出内联缓冲区的深层程序改用每个线程一份的缓冲区，只增不减，
+    // 长到所需大小之后反复求值不再分配堆内存
+    static double* deepStack(size_t size) {
+        thread_local std::vector<double> buffer;
+        if (buffer.size() < size) buffer.resize(size);
+        return buffer.data();
+    }
+
+    std::vector<Instruction> code;
+    int depth = 0;
+    int maxDepth = 0;
+    int numVariables = 0;
+    int numTemps = 0;
+
+    // 表达式 DAG 的结点，left/right 为子结点编号(-1 表示无)
+    struct Node {
+        OpCode op;
+        int arg;
+        double value;
+        int left, right;
+    };
+    // 哈希合并用的结点键；常量按位模式比较，避免 NaN、-0.0 被错误合并
+    using NodeIndex = std::map<std::tuple<int, int, unsigned long long, int, int>, int>;
+
+    static bool isConst(const std::vector<Node>& nodes, int id, double value) {
+        return id >= 0 && nodes[id].op == PUSH_CONST && nodes[id].value == value;
+    }
+
+    // 在常量上执行一条指令，复用 eval 保证与运行时语义一致；
+    // 运行时会报错的情形(如除零)不折叠，留给求值时照常报错
+    static bool tryFold(const Instruction& ins, const std::vector<Node>& nodes, int a, int b, double& result) {
+        if (nodes[a].op != PUSH_CONST || (b >= 0 && nodes[b].op != PUSH_CONST)) return false;
+        CompiledExpression tmp;
+        tmp.code.push_back({PUSH_CONST, 0, nodes[a].value});
+        if (b >= 0) tmp.code.push_back({PUSH_CONST, 0, nodes[b].value});
+        tmp.code.push_back(ins);
+        tmp.maxDepth = 2;
+        try {
+            result = tmp.eval();
+            return true;
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    }
+
+    // 创建(或复用已有的相同)结点，并在此处完成常量折叠与强度削弱
+    static int makeNode(std::vector<Node>& nodes, NodeIndex& index,
+                        const Instruction& ins, int a, int b) {
+        double folded;
+        if (a >= 0 && tryFold(ins, nodes, a, b, folded)) {
+            return makeNode(nodes, index, {PUSH_CONST, 0, folded}, -1, -1);
+        }
+
+        switch (ins.op) {
+            case ADD:
+                if (isConst(nodes, b, 0)) return a;
+                if (isConst(nodes, a, 0)) return b;
+                break;
+            case SUB:
+                if (isConst(nodes, b, 0)) return a;
+                break;
+            case MUL:
+                if (isConst(nodes, b, 1)) return a;
+                if (isConst(nodes, a, 1)) return b;
+                break;
+            case DIV:
+                if (isConst(nodes, b, 1)) return a;
+                break;
+            case POW: {
+                // x^n (n 为 1..8 的整数) 按平方-乘法展开，x^2 => x*x
+                if (nodes[b].op != PUSH_CONST) break;
+                double e = nodes[b].value;
+                if (e != std::floor(e) || e < 1 || e > 8) break;
+                int n = static_cast<int>(e);
+                int result = -1, power = a;
+                while (n > 0) {
+                    if (n & 1) result = result < 0 ? power : makeNode(nodes, index, {MUL, 0, 0.0}, result, power);
+                    n >>= 1;
+                    if (n > 0) power = makeNode(nodes, index, {MUL, 0, 0.0}, power, power);
+                }
+                return result;
+            }
+            default:
+                break;
+        }
+
+        unsigned long long bits;
+        std::memcpy(&bits, &ins.value, sizeof(bits));
+        auto key = std::make_tuple(static_cast<int>(ins.op), ins.arg, bits, a, b);
+        auto it = index.find(key);
+        if (it != index.end()) return it->second;
+        nodes.push_back({ins.op, ins.arg, ins.value, a, b});
+        index[key] = nodes.size() - 1;
+        return nodes.size() - 1;
+    }
+
+    void emit(const Instruction& ins) {
+        switch (ins.op) {
+            case PUSH_CONST: case PUSH_VAR: depth++; break;
+            case LOAD: depth++; break;
+            case FAC: case NEG: case CALL: case STORE:
+                if (depth < 1) throw std::runtime_error("操作数不足");
+                break;
+            default:
+                if (depth < 2) throw std::runtime_error("操作数不足");
+                depth--;
+        }
+        maxDepth = std::max(maxDepth, depth);
+        code.push_back(ins);
+    }
+
+    void emitOperator(Calculator::Operator op) {
+        switch (op) {
+            case Calculator::ADD: emit({ADD, 0, 0.0}); break;
+            case Calculator::SUB: emit({SUB, 0, 0.0}); break;
+            case Calculator::MUL: emit({MUL, 0, 0.0}); break;
+            case Calculator::DIV: emit({DIV, 0, 0.0}); break;
+            case Calculator::POW: emit({POW, 0, 0.0}); break;
+            case Calculator::FAC: emit({FAC, 0, 0.0}); break;
+            case Calculator::NEG: emit({NEG, 0, 0.0}); break;
+            default: throw std::runtime_error("括号不匹配");
+        }
+    }
+
+    // Calculator::parse 的 Handler：把操作数和运算符依次翻译为指令
+    struct Emitter {
+        CompiledExpression& program;
+        const std::vector<std::string>& variables;
+
+        void pushNumber(double value) { program.emit({PUSH_CONST, 0, value}); }
+
+        void pushVariable(std::string_view name) {
+            auto it = std::find(variables.begin(), variables.end(), name);
+            if (it == variables.end()) throw std::runtime_error("未知变量: " + std::string(name));
+            program.emit({PUSH_VAR, static_cast<int>(it - variables.begin()), 0.0});
+        }
+
+        void applyFunction(int func) { program.emit({CALL, func, 0.0}); }
+
+        void applyOperator(Calculator::Operator op) { program.emitOperator(op); }
+    };
+};
+
+// 分片加锁的 LRU 缓存：按键的哈希值分到不同分片，各分片独立加锁，减少线程间争用。
+// 分片内的索引直接以这个哈希值为键、冲突时再比较字符串，每次查找只对键做一次哈希
+template<typename Value>
+class ConcurrentLRUCache {
+private:
+    using Item = std::pair<std::string, Value>;
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Item> items;     // 表头为最近使用
+        std::unordered_multimap<size_t, typename std::list<Item>::iterator> index;
+
+        typename std::list<Item>::iterator find(size_t hash, const std::string& key) {
+            auto [first, last] = index.equal_range(hash);
+            for (; first != last; ++first) {
+                if (first->second->first == key) return first->second;
+            }
+            return items.end();
+        }
+
+        void erase(size_t hash, typename std::list<Item>::iterator item) {
+            auto [first, last] = index.equal_range(hash);
+            for (; first != last; ++first) {
+                if (first->second == item) {
+                    index.erase(first);
+                    break;
+                }
+            }
+            items.erase(item);
+        }
+    };
+
+    std::vector<Shard> shards;
+    size_t shardCapacity;
+    std::atomic<long long> hits{0};
+    std::atomic<long long> misses{0};
+
+public:
+    ConcurrentLRUCache(size_t capacity, int numShards = 16)
+        : shards(numShards), shardCapacity(std::max<size_t>(1, capacity / numShards)) {
+        // 桶数一次预留到容量上限，缓存填充阶段不再反复 rehash
+        for (Shard& shard : shards) shard.index.reserve(shardCapacity);
+    }
+
+    bool get(const std::string& key, Value& value) {
+        size_t hash = std::hash<std::string>()(key);
+        Shard& shard = shards[hash % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.find(hash, key);
+        if (it == shard.items.end()) {
+            misses++;
+            return false;
+        }
+        shard.items.splice(shard.items.begin(), shard.items, it);
+        value = it->second;
+        hits++;
+        return true;
+    }
+
+    void put(const std::string& key, const Value& value) {
+        size_t hash = std::hash<std::string>()(key);
+        Shard& shard = shards[hash % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.find(hash, key);
+        if (it != shard.items.end()) {
+            it->second = value;
+            shard.items.splice(shard.items.begin(), shard.items, it);
+            return;
+        }
+        shard.items.emplace_front(key, value);
+        shard.index.emplace(hash, shard.items.begin());
+        if (shard.items.size() > shardCapacity) {
+            const std::string& oldest = shard.items.back().first;
+            shard.erase(std::hash<std::string>()(oldest), std::prev(shard.items.end()));
+        }
+    }
+
+    long long hitCount() const { return hits; }
+    long long missCount() const { return misses; }
+    double hitRatio() const {
+        long long total = hits + misses;
+        return total ? static_cast<double>(hits) / total : 0.0;
     }
 };
 
+// 工作窃取线程池：工作线程在构造时启动、析构时回收，各次 parallelFor 共用。
+// 任务区间按块分给各线程的双端队列，线程从自己队尾取块，
+// 自己的队列空了就从其他线程的队头窃取，负载不均时自动平衡
+class WorkStealingPool {
+private:
+    using Task = std::function<void(size_t, size_t)>;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, size_t>> chunks;
+    };
+
+    int numThreads;
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> workers;     // 调用线程自己充当 0 号线程，这里只有其余 numThreads-1 个
+
+    std::mutex callMutex;                 // 同一时刻只执行一次 parallelFor
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const Task* task = nullptr;
+    size_t generation = 0;                // 每次 parallelFor 加一，唤醒所有工作线程
+    int running = 0;                      // 本轮尚未取完任务的工作线程数
+    bool stopping = false;
+    std::exception_ptr failure;
+
+    // 先取自己队列的尾部，取空后依次窃取其他队列的头部，直到所有队列都空
+    void drain(int self, const Task& body) {
+        while (true) {
+            std::pair<size_t, size_t> range;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(queues[self].mutex);
+                if (!queues[self].chunks.empty()) {
+                    range = queues[self].chunks.back();
+                    queues[self].chunks.pop_back();
+                    found = true;
+                }
+            }
+            for (int k = 1; !found && k < numThreads; ++k) {
+                WorkQueue& victim = queues[(self + k) % numThreads];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.chunks.empty()) {
+                    range = victim.chunks.front();
+                    victim.chunks.pop_front();
+                    found = true;
+                }
+            }
+            if (!found) return;
+            try {
+                body(range.first, range.second);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    }
+
+    void workerLoop(int self) {
+        size_t seen = 0;
+        while (true) {
+            const Task* body;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                body = task;
+            }
+            drain(self, *body);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) done.notify_one();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(int threads)
+        : numThreads(std::max(1, threads)), queues(numThreads) {
+        for (int t = 1; t < numThreads; ++t) workers.emplace_back(&WorkStealingPool::workerLoop, this, t);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return numThreads; }
+
+    // 并行执行 body(begin, end)，覆盖 [0, n)，每块 grain 个元素。
+    // 所有块执行完才返回；任一块抛出的第一个异常在这里重新抛出
+    template<typename Body>
+    void parallelFor(size_t n, size_t grain, const Body& body) {
+        std::lock_guard<std::mutex> call(callMutex);
+        size_t chunk = 0;
+        for (size_t begin = 0; begin < n; begin += grain, ++chunk) {
+            queues[chunk % numThreads].chunks.push_back({begin, std::min(n, begin + grain)});
+        }
+
+        const Task current = std::cref(body);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &current;
+            running = numThreads - 1;
+            failure = nullptr;
+            ++generation;
+        }
+        wake.notify_all();
+        drain(0, current);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return running == 0; });
+        task = nullptr;
+        if (failure) std::rethrow_exception(failure);
+    }
+};
+
+// 非交互的批量求值服务：每行一个表达式，多线程并行求值，结果保持输入顺序。
+// 编译结果按表达式文本缓存，重复出现的公式跳过解析直接求值
+class BatchEvaluator {
+private:
+    // 缓存项：首次出现只做普通编译，命中次数达到 OPTIMIZE_AFTER 才换成优化后的程序。
+    // 一次优化约等于几十次未优化求值的耗时，只出现几次的公式不值得优化；
+    // 编译失败的行记住错误信息，再次出现时不再重复解析、抛异常
+    struct CacheEntry {
+        CompiledExpression program;
+        std::string error;
+        mutable std::atomic<int> hits{0};
+    };
+
+    WorkStealingPool pool;
+    ConcurrentLRUCache<std::shared_ptr<const CacheEntry>> cache;
+    static constexpr size_t GRAIN = 1024;
+    static constexpr int OPTIMIZE_AFTER = 64;
+
+    std::string evaluateLine(const std::string& line) {
+        std::shared_ptr<const CacheEntry> entry;
+        if (!cache.get(line, entry)) {
+            auto fresh = std::make_shared<CacheEntry>();
+            try {
+                fresh->program = CompiledExpression::compile(line);
+            } catch (const std::exception& e) {
+                fresh->error = std::string("错误: ") + e.what();
+            }
+            entry = fresh;
+            cache.put(line, entry);
+        } else if (entry->error.empty() && entry->hits.load(std::memory_order_relaxed) < OPTIMIZE_AFTER &&
+                   entry->hits.fetch_add(1, std::memory_order_relaxed) + 1 == OPTIMIZE_AFTER) {
+            // 恰好一个线程数到阈值，由它完成替换；优化后的项计数从阈值开始，不会再次触发
+            auto upgraded = std::make_shared<CacheEntry>();
+            upgraded->program = entry->program.optimized();
+            upgraded->hits = OPTIMIZE_AFTER;
+            entry = upgraded;
+            cache.put(line, entry);
+        }
+        if (!entry->error.empty()) return entry->error;
+
+        try {
+            return format(entry->program.eval());
+        } catch (const std::exception& e) {
+            return std::string("错误: ") + e.what();
+        }
+    }
+
+public:
+    BatchEvaluator(int threads, size_t cacheCapacity = 65536)
+        : pool(threads), cache(cacheCapacity) {}
+
+    // 按 "%.6f" 格式输出结果。std::to_chars 不解析格式串、不受 locale 影响，
+    // 比 snprintf 快数倍，而格式化在缓存命中后是每行最大的开销
+    static std::string format(double value) {
+        char buffer[320];     // 定点格式下 double 最长约 317 个字符
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+        return std::string(buffer, result.ptr);
+    }
+
+    std::vector<std::string> run(const std::vector<std::string>& lines) {
+        std::vector<std::string> results(lines.size());
+        pool.parallelFor(lines.size(), GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) results[i] = evaluateLine(lines[i]);
+        });
+        return results;
+    }
+
+    double cacheHitRatio() const { return cache.hitRatio(); }
+    int threadCount() const { return pool.threadCount(); }
+};
+
 void runCalculatorTests() {
     std::cout << "=== 计算器测试 ===\n";
     
@@ -255,8 +1076,454 @@ void runCalculatorTests() {
     }
 }
 
-int main() {
+void runCompiledTests() {
+    std::cout << "\n=== 编译型表达式测试 ===\n";
+
+    std::vector<std::string> tests = {
+        "2+3", "2*3+5", "(2+3)*5", "2^3", "5!",
+        "2+3*4", "sin(30)", "cos(60)", "sqrt(16)", "2+sin(30)"
+    };
+
+    for (const auto& test : tests) {
+        try {
+            double expected = FunctionEvaluator::evaluateExtended(test);
+            double result = CompiledExpression::compile(test).eval();
+            bool same = std::abs(result - expected) <= 1e-6 * std::max(1.0, std::abs(expected));
+            std::cout << test << " = " << std::fixed << std::setprecision(6) << result
+                      << (same ? "  [一致]" : "  [不一致]") << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << test << " -> 错误: " << e.what() << std::endl;
+        }
+    }
+
+    auto program = CompiledExpression::compile("x^2+3*x-y/(x+1)", {"x", "y"});
+    auto optimized = program.optimized();
+    double vars[] = {2.0, 6.0};
+    std::cout << "x^2+3*x-y/(x+1), x=2, y=6 = " << program.eval(vars)
+              << " (" << program.size() << " 条指令, 优化后 " << optimized.size() << " 条 = "
+              << optimized.eval(vars) << ")" << std::endl;
+
+    CompiledExpression empty;
+    double batch[4] = {1, 1, 1, 1};
+    CompiledExpression::evalBatch(empty, nullptr, 4, batch);
+    bool zero = empty.eval() == 0 && std::all_of(batch, batch + 4, [](double v) { return v == 0; });
+    std::cout << "空程序: eval 与 evalBatch 均为 0" << (zero ? "  [一致]" : "  [不一致]") << std::endl;
+}
+
+void runAllocationTests() {
+    std::cout << "\n=== 零分配求值测试 ===\n";
+
+    std::vector<std::string> tests = {
+        "2+3", "(2+3)*5-4/2", "2^10+5!", "sqrt(16)+sin(30)*cos(60)", "-(1.5+2.25)*abs(-3)",
+        "ln(10)/log(100)+((((1+2)*3)+4)*5)"
+    };
+    auto program = CompiledExpression::compile("x^2+3*x-y/(x+1)+sin(x)*sin(x)", {"x", "y"}).optimized();
+    // 右结合嵌套 100 层，运算栈深度超过内联缓冲区的 64 个槽位
+    std::string nested = "x";
+    for (int k = 0; k < 100; ++k) nested = "x+(" + nested + ")";
+    auto deep = CompiledExpression::compile(nested, {"x"});
+
+    // 预热：让各线程工作区的栈长到所需容量
+    for (const auto& test : tests) Calculator::evaluate(test);
+
+    bool allPassed = true;
+    for (const auto& test : tests) {
+        long long before = allocationCount;
+        double sum = 0;
+        for (int k = 0; k < 1000; ++k) sum += Calculator::evaluate(test);
+        long long allocations = allocationCount - before;
+        allPassed &= (allocations == 0);
+        std::cout << test << ": 1000 次求值共分配 " << allocations << " 次"
+                  << (allocations == 0 ? "  [通过]" : "  [失败]") << std::endl;
+    }
+
+    long long before = allocationCount;
+    double sum = 0;
+    for (int k = 0; k < 1000; ++k) {
+        double vars[] = {k * 0.5, 1.0};
+        sum += program.eval(vars);
+    }
+    long long allocations = allocationCount - before;
+    allPassed &= (allocations == 0);
+    std::cout << "编译型求值: 1000 次共分配 " << allocations << " 次"
+              << (allocations == 0 ? "  [通过]" : "  [失败]") << std::endl;
+
+    double x = 0.5;
+    deep.eval(&x);      // 预热：让本线程的深层缓冲区长到所需大小
+    before = allocationCount;
+    for (int k = 0; k < 1000; ++k) {
+        x = k * 0.25;
+        sum += deep.eval(&x);
+    }
+    allocations = allocationCount - before;
+    allPassed &= (allocations == 0);
+    std::cout << "深层嵌套 (" << deep.stackDepth() + deep.tempCount() << " 个栈槽): 1000 次求值共分配 "
+              << allocations << " 次" << (allocations == 0 ? "  [通过]" : "  [失败]") << std::endl;
+    std::cout << (allPassed ? "全部通过" : "存在堆分配!") << std::endl;
+}
+
+// 原先逐次连乘的阶乘，作为精度和性能的对照
+double factorialByLoop(int n) {
+    double result = 1;
+    for (int i = 2; i <= n; ++i) result *= i;
+    return result;
+}
+
+void runMathKernelTests() {
+    std::cout << "\n=== 阶乘表与整数幂精度测试 ===\n";
+
+    int tableMismatches = 0;
+    for (int n = 0; n <= 171; ++n) {
+        tableMismatches += (Calculator::evaluate(std::to_string(n) + "!") != factorialByLoop(n));
+    }
+    std::cout << "阶乘表 0!..171! 与逐次连乘不一致: " << tableMismatches << " 个"
+              << (tableMismatches == 0 ? "  [通过]" : "  [失败]") << std::endl;
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> baseDis(-4.0, 4.0);
+    double maxRelError = 0;
+    for (int k = 0; k < 100000; ++k) {
+        double base = baseDis(gen);
+        int exponent = static_cast<int>(gen() % 129) - 64;
+        double expected = std::pow(base, exponent);
+        double actual = Calculator::power(base, exponent);
+        if (std::isfinite(expected) && expected != 0) {
+            maxRelError = std::max(maxRelError, std::abs(actual - expected) / std::abs(expected));
+        }
+    }
+    std::cout << "平方-乘法整数幂 (|指数|<=64) 相对 std::pow 最大相对误差: " << std::scientific
+              << std::setprecision(2) << maxRelError << std::defaultfloat
+              << (maxRelError < 1e-13 ? "  [通过]" : "  [失败]") << std::endl;
+
+    Calculator::setGammaFactorial(true);
+    double half = Calculator::evaluate("0.5!");
+    double five = Calculator::evaluate("5!");
+    bool negativeRejected = false;
+    try {
+        Calculator::evaluate("(-3)!");
+    } catch (const std::exception&) {
+        negativeRejected = true;
+    }
+    Calculator::setGammaFactorial(false);
+    bool gammaOk = std::abs(half - std::sqrt(M_PI) / 2) < 1e-15 && five == 120 && negativeRejected;
+    std::cout << "Gamma 扩展: 0.5! = " << std::setprecision(15) << half << ", 5! = " << five
+              << ", (-3)! " << (negativeRejected ? "报错" : "未报错")
+              << (gammaOk ? "  [通过]" : "  [失败]") << std::endl;
+}
+
+void runMathKernelBenchmark(int iterations) {
+    std::cout << "\n=== 阶乘 / 整数幂微基准 (" << iterations << " 次) ===\n";
+
+    auto timeIt = [iterations](auto&& body) {
+        double sink = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < iterations; ++k) sink += body(k);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+        volatile double keep = sink;
+        (void)keep;
+        return elapsed.count() / iterations;
+    };
+
+    double loop = timeIt([](int k) { return factorialByLoop(k % 171); });
+    double table = timeIt([](int k) { return Calculator::factorial(k % 171); });
+    std::cout << "阶乘 (n<=170): 逐次连乘 " << std::fixed << std::setprecision(2) << loop
+              << " ns  查表 " << table << " ns  加速比 " << loop / table << "x" << std::endl;
+
+    for (double exponent : {2.0, 7.0, 31.0, -5.0, 2.5}) {
+        double stdPow = timeIt([exponent](int k) { return std::pow(1.0 + (k & 1023) * 1e-3, exponent); });
+        double fastPow = timeIt([exponent](int k) { return Calculator::power(1.0 + (k & 1023) * 1e-3, exponent); });
+        std::cout << "x^" << std::defaultfloat << exponent << std::fixed << ": std::pow " << stdPow << " ns  Calculator::power "
+                  << fastPow << " ns  加速比 " << stdPow / fastPow << "x" << std::endl;
+    }
+}
+
+// 把变量的取值以文本形式代入表达式，模拟“每次重新解析”的调用方式
+std::string bindVariables(const std::string& expr, const std::vector<std::string>& names, const double* values) {
+    std::string result;
+    size_t i = 0;
+    while (i < expr.length()) {
+        if (std::isalpha(static_cast<unsigned char>(expr[i]))) {
+            size_t start = i;
+            while (i < expr.length() && std::isalnum(static_cast<unsigned char>(expr[i]))) i++;
+            std::string name = expr.substr(start, i - start);
+            auto it = std::find(names.begin(), names.end(), name);
+            if (it != names.end()) {
+                result += "(" + std::to_string(values[it - names.begin()]) + ")";
+            } else {
+                result += name;
+            }
+        } else {
+            result += expr[i++];
+        }
+    }
+    return result;
+}
+
+void runCompiledBenchmark(int iterations) {
+    std::cout << "\n=== 编译求值 vs 重新解析 (" << iterations << " 次) ===\n";
+
+    std::vector<std::string> names = {"x", "y"};
+    std::vector<std::string> formulas = {
+        "x*x+3*x-5/(y+1)", "sqrt(x*x+y*y)", "(x+1)^3-2*y", "2*sin(x)+cos(y)*abs(x-y)"
+    };
+
+    for (const auto& formula : formulas) {
+        auto program = CompiledExpression::compile(formula, names);
+
+        double sumReparse = 0, sumCompiled = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < iterations; ++k) {
+            double vars[] = {(k % 64) * 0.25, (k % 16) * 0.5};
+            sumReparse += FunctionEvaluator::evaluateExtended(bindVariables(formula, names, vars));
+        }
+        auto mid = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < iterations; ++k) {
+            double vars[] = {(k % 64) * 0.25, (k % 16) * 0.5};
+            sumCompiled += program.eval(vars);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double, std::nano> reparse = mid - start;
+        std::chrono::duration<double, std::nano> compiled = end - mid;
+        std::cout << formula << "\n  重新解析: " << std::fixed << std::setprecision(1)
+                  << reparse.count() / iterations << " ns/次"
+                  << "  编译求值: " << compiled.count() / iterations << " ns/次"
+                  << "  加速比: " << std::setprecision(1) << reparse.count() / compiled.count() << "x"
+                  << "  结果差: " << std::scientific << std::setprecision(2)
+                  << std::abs(sumReparse - sumCompiled) / std::max(1.0, std::abs(sumReparse))
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+void runBatchBenchmark(size_t rows) {
+    std::cout << "\n=== 逐行求值 vs 列式批量求值 (" << rows << " 行) ===\n";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0.5, 100.0);
+    std::vector<double> xs(rows), ys(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        xs[r] = dis(gen);
+        ys[r] = dis(gen);
+    }
+    const double* columns[] = {xs.data(), ys.data()};
+
+    std::vector<std::string> formulas = {
+        "x*x+3*x-5/(y+1)", "sqrt(x*x+y*y)", "(x+1)^3-2*y", "2*sin(x)+cos(y)*abs(x-y)", "ln(x)*0.3+log(y)*0.7"
+    };
+
+    for (const auto& formula : formulas) {
+        auto program = CompiledExpression::compile(formula, {"x", "y"});
+        std::vector<double> scalarOut(rows), batchOut(rows);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rows; ++r) {
+            double vars[] = {xs[r], ys[r]};
+            scalarOut[r] = program.eval(vars);
+        }
+        auto mid = std::chrono::high_resolution_clock::now();
+        CompiledExpression::evalBatch(program, columns, rows, batchOut.data());
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double maxDiff = 0;
+        for (size_t r = 0; r < rows; ++r) maxDiff = std::max(maxDiff, std::abs(scalarOut[r] - batchOut[r]));
+
+        std::chrono::duration<double> scalar = mid - start;
+        std::chrono::duration<double> batch = end - mid;
+        std::cout << formula << "\n  逐行: " << std::fixed << std::setprecision(1)
+                  << rows / scalar.count() / 1e6 << " M行/s"
+                  << "  批量: " << rows / batch.count() / 1e6 << " M行/s"
+                  << "  加速比: " << scalar.count() / batch.count() << "x"
+                  << "  最大误差: " << std::scientific << std::setprecision(2) << maxDiff
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+void runOptimizerBenchmark(int iterations) {
+    std::cout << "\n=== 常量折叠 / 公共子表达式合并 (" << iterations << " 次) ===\n";
+
+    std::vector<std::string> formulas = {
+        "sqrt(2)*3^4*x+sin(x)*sin(x)+cos(y)^2",
+        "x^2+2*x*y+y^2",
+        "(5!/3!)*x+abs(x-y)*abs(x-y)/(abs(x-y)+1)",
+        "ln(x+1)^3-ln(x+1)^2+ln(x+1)*(2^10-1000)",
+        "2*sin(x)+cos(y)*abs(x-y)"
+    };
+
+    for (const auto& formula : formulas) {
+        auto program = CompiledExpression::compile(formula, {"x", "y"});
+        auto optimized = program.optimized();
+
+        double sumPlain = 0, sumOptimized = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < iterations; ++k) {
+            double vars[] = {(k % 64) * 0.25, (k % 16) * 0.5};
+            sumPlain += program.eval(vars);
+        }
+        auto mid = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < iterations; ++k) {
+            double vars[] = {(k % 64) * 0.25, (k % 16) * 0.5};
+            sumOptimized += optimized.eval(vars);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double, std::nano> plain = mid - start;
+        std::chrono::duration<double, std::nano> fast = end - mid;
+        std::cout << formula << "\n  指令数: " << program.size() << " -> " << optimized.size()
+                  << " (临时槽位 " << optimized.tempCount() << ")"
+                  << "  求值: " << std::fixed << std::setprecision(1) << plain.count() / iterations
+                  << " -> " << fast.count() / iterations << " ns/次"
+                  << "  加速比: " << plain.count() / fast.count() << "x"
+                  << "  结果差: " << std::scientific << std::setprecision(2)
+                  << std::abs(sumPlain - sumOptimized) / std::max(1.0, std::abs(sumPlain))
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+// 生成约 tokens 个记号的长表达式: 0 平铺的四则运算, 1 深层嵌套的函数调用, 2 深层嵌套的括号
+std::string generateLongExpression(int kind, int tokens) {
+    std::string expr;
+    if (kind == 0) {
+        const char ops[] = {'+', '*', '-', '/'};
+        expr = "1";
+        for (int k = 1; k * 2 < tokens; ++k) {
+            expr += ops[k % 4];
+            expr += std::to_string(k % 9 + 1);
+        }
+    } else if (kind == 1) {
+        int depth = tokens / 4;     // 每层: 函数名 ( ... )
+        for (int k = 0; k < depth; ++k) expr += (k % 2 ? "abs(" : "sqrt(");
+        expr += "2";
+        expr += std::string(depth, ')');
+    } else {
+        int depth = tokens / 4;     // 每层: 1 + ( ... )
+        for (int k = 0; k < depth; ++k) expr += "1+(";
+        expr += "1";
+        expr += std::string(depth, ')');
+    }
+    return expr;
+}
+
+void runScalingBenchmark() {
+    std::cout << "\n=== 长表达式扩展性测试 (单遍扫描应为线性) ===\n";
+
+    const char* kindNames[] = {"平铺运算", "嵌套函数", "嵌套括号"};
+    for (int kind = 0; kind < 3; ++kind) {
+        std::cout << kindNames[kind] << ":\n";
+        for (int tokens = 10000; tokens <= 160000; tokens *= 2) {
+            std::string expr = generateLongExpression(kind, tokens);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            double value = Calculator::evaluate(expr);
+            auto mid = std::chrono::high_resolution_clock::now();
+            auto program = CompiledExpression::compile(expr);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            std::chrono::duration<double, std::nano> evalTime = mid - start;
+            std::chrono::duration<double, std::nano> compileTime = end - mid;
+            std::cout << "  " << std::setw(7) << tokens << " 记号: 求值 "
+                      << std::fixed << std::setprecision(1) << evalTime.count() / tokens << " ns/记号"
+                      << "  编译 " << compileTime.count() / tokens << " ns/记号"
+                      << "  结果 " << std::setprecision(4) << value
+                      << (program.eval() == value ? "" : "  [不一致]") << std::endl;
+        }
+    }
+}
+
+// 生成 lines 行的合成表达式文件：公式取自 distinct 个不同模板实例，按偏斜分布抽取，
+// 少数热门公式反复出现，贴近真实批处理作业的重复率
+void writeSyntheticExpressions(const std::string& path, size_t lines, int distinct) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> num(1, 99);
+    std::vector<std::string> formulas;
+    for (int k = 0; k < distinct; ++k) {
+        std::string a = std::to_string(num(gen)), b = std::to_string(num(gen)), c = std::to_string(num(gen));
+        switch (k % 5) {
+            case 0: formulas.push_back("(" + a + "+" + b + ")*" + c + "-sqrt(" + b + ")"); break;
+            case 1: formulas.push_back("sin(" + a + ")^2+cos(" + b + ")^2*" + c); break;
+            case 2: formulas.push_back(std::to_string(k % 10) + "!/(" + a + "+1)-ln(" + b + ")"); break;
+            case 3: formulas.push_back("abs(" + a + "-" + b + ")/(" + c + "+" + a + ")^2"); break;
+            default: formulas.push_back("log(" + a + "*" + b + ")+2^" + std::to_string(k % 12) + "-" + c + "/" + b);
+        }
+    }
+
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::ofstream out(path);
+    for (size_t i = 0; i < lines; ++i) {
+        double r = u(gen);
+        out << formulas[static_cast<int>(distinct * r * r * r)] << '\n';
+    }
+}
+
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("无法打开文件: " + path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+void runServiceBenchmark(size_t lines) {
+    std::cout << "\n=== 批量求值服务 (" << lines << " 行) ===\n";
+
+    const std::string path = "calculator_batch_bench.txt";
+    writeSyntheticExpressions(path, lines, 20000);
+    auto input = readLines(path);
+    std::remove(path.c_str());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::string> reference(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        try {
+            reference[i] = BatchEvaluator::format(Calculator::evaluate(input[i]));
+        } catch (const std::exception& e) {
+            reference[i] = std::string("错误: ") + e.what();
+        }
+    }
+    std::chrono::duration<double> serial = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "逐行解析(单线程): " << std::fixed << std::setprecision(2)
+              << input.size() / serial.count() / 1e6 << " M行/s\n";
+
+    int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        BatchEvaluator service(threads);
+        auto begin = std::chrono::high_resolution_clock::now();
+        auto results = service.run(input);
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - begin;
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < results.size(); ++i) mismatches += (results[i] != reference[i]);
+        std::cout << "缓存+工作窃取 " << threads << " 线程: " << input.size() / elapsed.count() / 1e6
+                  << " M行/s  命中率: " << service.cacheHitRatio() * 100 << "%"
+                  << "  与逐行结果不一致: " << mismatches << " 行\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--batch") {
+        int threads = argc > 3 ? std::stoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+        BatchEvaluator service(threads);
+        for (const auto& result : service.run(readLines(argv[2]))) std::cout << result << '\n';
+        std::cerr << "缓存命中率: " << std::fixed << std::setprecision(2)
+                  << service.cacheHitRatio() * 100 << "%" << std::endl;
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        int iterations = argc > 2 ? std::stoi(argv[2]) : 200000;
+        runCompiledBenchmark(iterations);
+        runBatchBenchmark(static_cast<size_t>(iterations) * 10);
+        runScalingBenchmark();
+        runOptimizerBenchmark(iterations);
+        runServiceBenchmark(static_cast<size_t>(iterations) * 5);
+        runMathKernelBenchmark(iterations * 10);
+        return 0;
+    }
+
     runCalculatorTests();
+    runCompiledTests();
+    runAllocationTests();
+    runMathKernelTests();
     
     std::cout << "\n=== 交互式计算器 ===\n输入表达式 (quit退出):\n";
     std::string input;
@@ -5,6 +5,17 @@
 #include <ctime>
 #include <cmath>
 #include <iomanip>
+#include <cstring>
+#include <chrono>
+#include <new>
+#include <string>
+#include <functional>
+#include <fstream>
+
+#include "../common/merge_sort.h"
+#include "../common/parallel_sort.h"
+#include "../common/benchmark.h"
+#include "../common/data_generator.h"
 
 class Complex {
 private:
@@ -45,27 +56,599 @@ public:
     }
 };
 
-class ComplexVectorOperations {
+// 对齐分配器：数组首地址按 Align 字节对齐，便于编译器生成对齐的向量加载
+template<typename T, size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+// 结构数组(SoA)形式的复数容器：实部、虚部各自连续存放。
+// 批量求模、查找、区间过滤等内核只读需要的那一列，循环体无分支，可直接向量化
+class ComplexSoA {
+private:
+    using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+    static constexpr size_t BLOCK = 256;
+
+    AlignedVector re;
+    AlignedVector im;
+
 public:
-    static std::vector<Complex> generateRandomVector(int size) {
+    ComplexSoA() = default;
+
+    explicit ComplexSoA(const std::vector<Complex>& vec) : re(vec.size()), im(vec.size()) {
+        for (size_t i = 0; i < vec.size(); ++i) {
+            re[i] = vec[i].getReal();
+            im[i] = vec[i].getImag();
+        }
+    }
+
+    size_t size() const { return re.size(); }
+    bool empty() const { return re.empty(); }
+    const double* realData() const { return re.data(); }
+    const double* imagData() const { return im.data(); }
+
+    Complex operator[](size_t i) const { return Complex(re[i], im[i]); }
+
+    void push_back(const Complex& c) {
+        re.push_back(c.getReal());
+        im.push_back(c.getImag());
+    }
+
+    std::vector<Complex> toVector() const {
         std::vector<Complex> vec;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> dis(-10.0, 10.0);
-        
-        for (int i = 0; i < size; ++i) {
-            if (i % 5 == 0) {
-                vec.emplace_back(1.5, 2.5);
-            } else {
-                vec.emplace_back(dis(gen), dis(gen));
+        vec.reserve(size());
+        for (size_t i = 0; i < size(); ++i) vec.emplace_back(re[i], im[i]);
+        return vec;
+    }
+
+    // 批量计算 |z|^2，out 至少 size() 个元素
+    void squaredMagnitudes(double* out) const {
+        const double* r = re.data();
+        const double* m = im.data();
+        const size_t n = size();
+        for (size_t i = 0; i < n; ++i) out[i] = r[i] * r[i] + m[i] * m[i];
+    }
+
+    // 批量计算 |z|，与 Complex::magnitude 逐位一致
+    void magnitudes(double* out) const {
+        const double* r = re.data();
+        const double* m = im.data();
+        const size_t n = size();
+        for (size_t i = 0; i < n; ++i) out[i] = std::sqrt(r[i] * r[i] + m[i] * m[i]);
+    }
+
+    // 按 Complex::operator== 的 epsilon 语义查找第一个相等元素，找不到返回 -1。
+    // 逐块做无分支的“是否命中”归约，只有命中的块才逐个定位
+    int find(const Complex& target) const {
+        const double epsilon = 1e-9;
+        const double tr = target.getReal(), ti = target.getImag();
+        const double* r = re.data();
+        const double* m = im.data();
+        const size_t n = size();
+
+        for (size_t base = 0; base < n; base += BLOCK) {
+            const size_t end = std::min(n, base + BLOCK);
+            long long hits = 0;
+            for (size_t i = base; i < end; ++i) {
+                hits += (std::abs(r[i] - tr) < epsilon) & (std::abs(m[i] - ti) < epsilon);
+            }
+            if (hits == 0) continue;
+            for (size_t i = base; i < end; ++i) {
+                if (std::abs(r[i] - tr) < epsilon && std::abs(m[i] - ti) < epsilon) return i;
+            }
+        }
+        return -1;
+    }
+
+    // 返回模在 [minMag, maxMag) 内的元素下标(升序)，magOut 非空时一并返回这些元素的模
+    std::vector<size_t> filterByMagnitude(double minMag, double maxMag, std::vector<double>* magOut = nullptr) const {
+        std::vector<size_t> result;
+        double mags[BLOCK];
+        size_t picked[BLOCK];
+        const size_t n = size();
+
+        for (size_t base = 0; base < n; base += BLOCK) {
+            const size_t len = std::min(BLOCK, n - base);
+            const double* r = re.data() + base;
+            const double* m = im.data() + base;
+            for (size_t k = 0; k < len; ++k) mags[k] = std::sqrt(r[k] * r[k] + m[k] * m[k]);
+
+            // 无分支压缩：总是写入，命中时才前移写指针
+            size_t count = 0;
+            for (size_t k = 0; k < len; ++k) {
+                picked[count] = k;
+                count += (mags[k] >= minMag) & (mags[k] < maxMag);
+            }
+            for (size_t k = 0; k < count; ++k) {
+                result.push_back(base + picked[k]);
+                if (magOut) magOut->push_back(mags[picked[k]]);
+            }
+        }
+        return result;
+    }
+};
+
+// 按 epsilon 网格分桶的哈希索引。格子边长 1e-7 远大于 operator== 的容差 1e-9，
+// 与目标相等的元素只可能落在 [目标-2e-9, 目标+2e-9] 覆盖的格子中：通常只需查 1 个格子，
+// 目标靠近格子边界时最多查 2x2 个。每个格子里的元素按下标升序串成链表，
+// find 返回所有相等元素中的最小下标，与线性查找的结果一致；期望 O(1)。
+// 索引只记录下标，被索引的向量修改后需要重建
+class ComplexHashIndex {
+private:
+    static constexpr double CELL = 1e-7;
+    static constexpr double MARGIN = 2e-9;
+    static constexpr long long LIMIT = 1LL << 62;
+
+    struct Cell {
+        long long x, y;
+        int head, tail;        // head < 0 表示空槽
+    };
+
+    const std::vector<Complex>* source = nullptr;
+    std::vector<Cell> table;
+    std::vector<int> next;     // 同一格子中下一个元素的下标
+    size_t cells = 0;
+
+public:
+    ComplexHashIndex() = default;
+
+    explicit ComplexHashIndex(const std::vector<Complex>& vec) {
+        build(vec);
+    }
+
+    void build(const std::vector<Complex>& vec) {
+        attach(vec, vec.size());
+        for (size_t i = 0; i < vec.size(); ++i) add(i);
+    }
+
+    // 清空索引并绑定向量，之后按下标升序逐个 add
+    void attach(const std::vector<Complex>& vec, size_t expected) {
+        source = &vec;
+        cells = 0;
+        next.clear();
+        next.reserve(expected);
+        size_t capacity = 16;
+        while (3 * capacity < 4 * expected) capacity *= 2;
+        table.assign(capacity, Cell{0, 0, -1, -1});
+    }
+
+    void add(size_t index) {
+        if (next.size() <= index) next.resize(index + 1, -1);
+        const Complex& c = (*source)[index];
+        if (!std::isfinite(c.getReal()) || !std::isfinite(c.getImag())) return;     // 不与任何数相等
+        if (4 * (cells + 1) > 3 * table.size()) grow();
+
+        Cell& cell = table[slot(quantize(c.getReal()), quantize(c.getImag()))];
+        if (cell.head < 0) {
+            cell = {quantize(c.getReal()), quantize(c.getImag()), static_cast<int>(index), static_cast<int>(index)};
+            cells++;
+        } else {
+            next[cell.tail] = index;
+            cell.tail = index;
+        }
+    }
+
+    int find(const Complex& target) const {
+        if (table.empty() || !std::isfinite(target.getReal()) || !std::isfinite(target.getImag())) return -1;
+        long long xs[2], ys[2];
+        int nx = cellsNear(target.getReal(), xs), ny = cellsNear(target.getImag(), ys);
+        int best = -1;
+        for (int a = 0; a < nx; ++a) {
+            for (int b = 0; b < ny; ++b) {
+                const Cell& cell = table[slot(xs[a], ys[b])];
+                for (int i = cell.head; i >= 0 && (best < 0 || i < best); i = next[i]) {
+                    if ((*source)[i] == target) {
+                        best = i;
+                        break;
+                    }
+                }
             }
         }
+        return best;
+    }
+
+private:
+    static long long quantize(double value) {
+        double cell = std::floor(value / CELL);
+        if (cell > LIMIT) return LIMIT;
+        if (cell < -LIMIT) return -LIMIT;
+        return static_cast<long long>(cell);
+    }
+
+    // 与 value 相差不足容差的数可能落入的格子，返回个数(1 或 2)
+    static int cellsNear(double value, long long cells[2]) {
+        cells[0] = quantize(value - MARGIN);
+        cells[1] = quantize(value + MARGIN);
+        return cells[1] != cells[0] ? 2 : 1;
+    }
+
+    static size_t hash(long long x, long long y) {
+        unsigned long long h = static_cast<unsigned long long>(x) * 0x9E3779B97F4A7C15ULL
+                             ^ static_cast<unsigned long long>(y) * 0xC2B2AE3D27D4EB4FULL;
+        return h ^ (h >> 31);
+    }
+
+    // 线性探测：返回格子 (x, y) 所在的槽，不存在时返回应插入的空槽
+    size_t slot(long long x, long long y) const {
+        size_t mask = table.size() - 1;
+        size_t i = hash(x, y) & mask;
+        while (table[i].head >= 0 && (table[i].x != x || table[i].y != y)) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        std::vector<Cell> old(table.size() * 2, Cell{0, 0, -1, -1});
+        old.swap(table);
+        for (const Cell& cell : old) {
+            if (cell.head >= 0) table[slot(cell.x, cell.y)] = cell;
+        }
+    }
+};
+
+// 分块序列：带计数的 B+ 树。叶子存放至多 LEAF_CAPACITY 个连续的元素，并按次序串成双向链表；
+// 内部节点记录每棵子树的元素个数，按位置定位只需自顶向下比较计数。
+// 按位置插入/删除为 O(log n)，叶内移动的元素不超过 LEAF_CAPACITY 个；
+// 顺序遍历沿叶子链表逐块进行，接近连续数组的速度。
+// 叶子满时对半分裂；删除后过空的节点与相邻兄弟合并，避免大量半空叶子拖慢遍历
+class ComplexSequence {
+private:
+    static constexpr int LEAF_CAPACITY = 512;
+    static constexpr int BRANCH_CAPACITY = 64;
+
+    struct Node {
+        bool leaf;
+        int count = 0;             // 叶子：元素个数；内部节点：子节点个数
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+
+    struct Leaf : Node {
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+        Complex items[LEAF_CAPACITY];
+        Leaf() : Node(true) {}
+    };
+
+    struct Branch : Node {
+        size_t sizes[BRANCH_CAPACITY + 1];     // 多留一格，插入后再分裂
+        Node* children[BRANCH_CAPACITY + 1];
+        Branch() : Node(false) {}
+    };
+
+    Node* root;
+    Leaf* first;                   // 最左的叶子，遍历的起点
+    size_t total = 0;
+
+public:
+    class const_iterator {
+    private:
+        const Leaf* leaf;
+        int index;
+
+    public:
+        const_iterator(const Leaf* l, int i) : leaf(l), index(i) {
+            skipEmpty();
+        }
+
+        const Complex& operator*() const { return leaf->items[index]; }
+        const Complex* operator->() const { return &leaf->items[index]; }
+
+        const_iterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return leaf == other.leaf && index == other.index; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        // 走完一个叶子后跳到下一个非空叶子；末尾停在最后一个叶子的 count 处，即 end()
+        void skipEmpty() {
+            while (index == leaf->count && leaf->next) {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+    };
+
+    ComplexSequence() {
+        first = new Leaf();
+        root = first;
+    }
+
+    // 自底向上批量建树：叶子与内部节点都只填到 3/4，给随后的插入留出空间
+    explicit ComplexSequence(const std::vector<Complex>& vec) : ComplexSequence() {
+        if (vec.empty()) return;
+        destroy(root);
+
+        const size_t leafFill = LEAF_CAPACITY * 3 / 4;
+        std::vector<Node*> level;
+        std::vector<size_t> sizes;
+        Leaf* prev = nullptr;
+        for (size_t begin = 0; begin < vec.size(); begin += leafFill) {
+            Leaf* leaf = new Leaf();
+            leaf->count = static_cast<int>(std::min(leafFill, vec.size() - begin));
+            std::copy(vec.begin() + begin, vec.begin() + begin + leaf->count, leaf->items);
+            leaf->prev = prev;
+            if (prev) prev->next = leaf;
+            else first = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+            sizes.push_back(leaf->count);
+        }
+
+        const size_t branchFill = BRANCH_CAPACITY * 3 / 4;
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            std::vector<size_t> parentSizes;
+            for (size_t begin = 0; begin < level.size(); begin += branchFill) {
+                Branch* branch = new Branch();
+                size_t sum = 0;
+                for (size_t i = begin; i < std::min(level.size(), begin + branchFill); ++i) {
+                    branch->children[branch->count] = level[i];
+                    branch->sizes[branch->count++] = sizes[i];
+                    sum += sizes[i];
+                }
+                parents.push_back(branch);
+                parentSizes.push_back(sum);
+            }
+            level.swap(parents);
+            sizes.swap(parentSizes);
+        }
+        root = level[0];
+        total = vec.size();
+    }
+
+    ComplexSequence(const ComplexSequence& other) : ComplexSequence(other.toVector()) {}
+
+    ComplexSequence& operator=(const ComplexSequence& other) {
+        if (this != &other) {
+            ComplexSequence copy(other);
+            std::swap(root, copy.root);
+            std::swap(first, copy.first);
+            std::swap(total, copy.total);
+        }
+        return *this;
+    }
+
+    ~ComplexSequence() {
+        destroy(root);
+    }
+
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+
+    const_iterator begin() const { return const_iterator(first, 0); }
+
+    const_iterator end() const {
+        const Node* node = root;
+        while (!node->leaf) {
+            const Branch* branch = static_cast<const Branch*>(node);
+            node = branch->children[branch->count - 1];
+        }
+        const Leaf* last = static_cast<const Leaf*>(node);
+        return const_iterator(last, last->count);
+    }
+
+    const Complex& operator[](size_t pos) const {
+        const Node* node = root;
+        while (!node->leaf) {
+            const Branch* branch = static_cast<const Branch*>(node);
+            int i = 0;
+            while (pos >= branch->sizes[i]) pos -= branch->sizes[i++];
+            node = branch->children[i];
+        }
+        return static_cast<const Leaf*>(node)->items[pos];
+    }
+
+    // 逐块遍历：body(const Complex* data, size_t count)，比逐个迭代少一次分支判断
+    template<typename Body>
+    void forEachChunk(Body body) const {
+        for (const Leaf* leaf = first; leaf; leaf = leaf->next) body(leaf->items, static_cast<size_t>(leaf->count));
+    }
+
+    void insert(size_t pos, const Complex& c) {
+        Node* sibling = insertAt(root, pos, c);
+        if (sibling) {
+            Branch* top = new Branch();
+            top->children[0] = root;
+            top->sizes[0] = subtreeSize(root);
+            top->children[1] = sibling;
+            top->sizes[1] = subtreeSize(sibling);
+            top->count = 2;
+            root = top;
+        }
+        total++;
+    }
+
+    void push_back(const Complex& c) {
+        insert(total, c);
+    }
+
+    void erase(size_t pos) {
+        eraseAt(root, pos);
+        total--;
+        // 根只剩一个孩子时降低树高
+        while (!root->leaf && root->count == 1) {
+            Branch* old = static_cast<Branch*>(root);
+            root = old->children[0];
+            delete old;
+        }
+    }
+
+    std::vector<Complex> toVector() const {
+        std::vector<Complex> vec;
+        vec.reserve(total);
+        forEachChunk([&](const Complex* data, size_t count) { vec.insert(vec.end(), data, data + count); });
+        return vec;
+    }
+
+private:
+    static size_t subtreeSize(const Node* node) {
+        if (node->leaf) return node->count;
+        const Branch* branch = static_cast<const Branch*>(node);
+        size_t sum = 0;
+        for (int i = 0; i < branch->count; ++i) sum += branch->sizes[i];
+        return sum;
+    }
+
+    static void destroy(Node* node) {
+        if (!node->leaf) {
+            Branch* branch = static_cast<Branch*>(node);
+            for (int i = 0; i < branch->count; ++i) destroy(branch->children[i]);
+            delete branch;
+        } else {
+            delete static_cast<Leaf*>(node);
+        }
+    }
+
+    // 插入后若节点分裂，返回新的右兄弟
+    Node* insertAt(Node* node, size_t pos, const Complex& c) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (leaf->count < LEAF_CAPACITY) {
+                std::copy_backward(leaf->items + pos, leaf->items + leaf->count, leaf->items + leaf->count + 1);
+                leaf->items[pos] = c;
+                leaf->count++;
+                return nullptr;
+            }
+            Leaf* right = new Leaf();
+            int half = LEAF_CAPACITY / 2;
+            std::copy(leaf->items + half, leaf->items + LEAF_CAPACITY, right->items);
+            right->count = LEAF_CAPACITY - half;
+            leaf->count = half;
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (leaf->next) leaf->next->prev = right;
+            leaf->next = right;
+            if (pos <= static_cast<size_t>(half)) insertAt(leaf, pos, c);
+            else insertAt(right, pos - half, c);
+            return right;
+        }
+
+        Branch* branch = static_cast<Branch*>(node);
+        int i = 0;
+        while (i < branch->count - 1 && pos > branch->sizes[i]) pos -= branch->sizes[i++];
+        Node* sibling = insertAt(branch->children[i], pos, c);
+        if (!sibling) {
+            branch->sizes[i]++;
+            return nullptr;
+        }
+
+        std::copy_backward(branch->children + i + 1, branch->children + branch->count, branch->children + branch->count + 1);
+        std::copy_backward(branch->sizes + i + 1, branch->sizes + branch->count, branch->sizes + branch->count + 1);
+        branch->children[i + 1] = sibling;
+        branch->sizes[i] = subtreeSize(branch->children[i]);
+        branch->sizes[i + 1] = subtreeSize(sibling);
+        branch->count++;
+        if (branch->count <= BRANCH_CAPACITY) return nullptr;
+
+        Branch* right = new Branch();
+        int half = branch->count / 2;
+        right->count = branch->count - half;
+        std::copy(branch->children + half, branch->children + branch->count, right->children);
+        std::copy(branch->sizes + half, branch->sizes + branch->count, right->sizes);
+        branch->count = half;
+        return right;
+    }
+
+    void eraseAt(Node* node, size_t pos) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            std::copy(leaf->items + pos + 1, leaf->items + leaf->count, leaf->items + pos);
+            leaf->count--;
+            return;
+        }
+
+        Branch* branch = static_cast<Branch*>(node);
+        int i = 0;
+        while (pos >= branch->sizes[i]) pos -= branch->sizes[i++];
+        eraseAt(branch->children[i], pos);
+        branch->sizes[i]--;
+
+        Node* child = branch->children[i];
+        int capacity = child->leaf ? LEAF_CAPACITY : BRANCH_CAPACITY;
+        if (child->count >= capacity / 4) return;
+        if (i + 1 < branch->count && child->count + branch->children[i + 1]->count <= capacity * 3 / 4) {
+            mergeChildren(branch, i);
+        } else if (i > 0 && child->count + branch->children[i - 1]->count <= capacity * 3 / 4) {
+            mergeChildren(branch, i - 1);
+        } else if (child->count == 0) {
+            mergeChildren(branch, i > 0 ? i - 1 : i);   // 兄弟都较满时也要摘掉空节点
+        }
+    }
+
+    // 把第 i + 1 个孩子并入第 i 个(若只有一个孩子则不动)
+    void mergeChildren(Branch* branch, int i) {
+        if (i + 1 >= branch->count) return;
+        Node* left = branch->children[i];
+        Node* right = branch->children[i + 1];
+        if (left->leaf) {
+            Leaf* l = static_cast<Leaf*>(left);
+            Leaf* r = static_cast<Leaf*>(right);
+            if (l->count + r->count > LEAF_CAPACITY) return;
+            std::copy(r->items, r->items + r->count, l->items + l->count);
+            l->count += r->count;
+            l->next = r->next;
+            if (r->next) r->next->prev = l;
+            delete r;
+        } else {
+            Branch* l = static_cast<Branch*>(left);
+            Branch* r = static_cast<Branch*>(right);
+            if (l->count + r->count > BRANCH_CAPACITY) return;
+            std::copy(r->children, r->children + r->count, l->children + l->count);
+            std::copy(r->sizes, r->sizes + r->count, l->sizes + l->count);
+            l->count += r->count;
+            delete r;
+        }
+        branch->sizes[i] += branch->sizes[i + 1];
+        std::copy(branch->children + i + 2, branch->children + branch->count, branch->children + i + 1);
+        std::copy(branch->sizes + i + 2, branch->sizes + branch->count, branch->sizes + i + 1);
+        branch->count--;
+    }
+};
+
+class ComplexVectorOperations {
+public:
+    // 实部、虚部均匀分布在 [-10, 10)，每 5 个元素中有一个固定为 1.5+2.5i(重复数据)。
+    // 同一 seed 总是生成相同的向量；大规模数据由多个线程分块并行生成
+    static std::vector<Complex> generateRandomVector(size_t size, uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        return DataGenerator::generate<Complex>(size, seed, [](Xoshiro256& rng, size_t i) {
+            if (i % 5 == 0) return Complex(1.5, 2.5);
+            double re = rng.uniform(-10.0, 10.0);
+            return Complex(re, rng.uniform(-10.0, 10.0));
+        });
+    }
+
+    // 按模排成升序/降序的版本，供有序、逆序输入的测试使用
+    static std::vector<Complex> generateRandomVector(size_t size, DataGenerator::Order order,
+                                                     uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        std::vector<Complex> vec = generateRandomVector(size, seed);
+        DataGenerator::arrange(vec, order);
         return vec;
     }
     
-    static void shuffle(std::vector<Complex>& vec) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
+    static void shuffle(std::vector<Complex>& vec, uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        Xoshiro256 gen(seed);
         std::shuffle(vec.begin(), vec.end(), gen);
     }
     
@@ -73,6 +656,11 @@ public:
         auto it = std::find(vec.begin(), vec.end(), target);
         return it != vec.end() ? std::distance(vec.begin(), it) : -1;
     }
+
+    // 哈希索引版本：通常只探查目标所在的 1 个格子，目标贴近格子边界时最多探查相邻的 2x2 个格子
+    static int find(const ComplexHashIndex& index, const Complex& target) {
+        return index.find(target);
+    }
     
     static bool insert(std::vector<Complex>& vec, int index, const Complex& c) {
         if (index >= 0 && index <= static_cast<int>(vec.size())) {
@@ -89,11 +677,60 @@ public:
         }
         return false;
     }
+
+    // 分块序列版本：与 std::vector 版本同名同参，调用方换用 ComplexSequence 即可
+    static int find(const ComplexSequence& seq, const Complex& target) {
+        int index = 0;
+        for (const auto& c : seq) {
+            if (c == target) return index;
+            index++;
+        }
+        return -1;
+    }
+
+    static bool insert(ComplexSequence& seq, int index, const Complex& c) {
+        if (index >= 0 && index <= static_cast<int>(seq.size())) {
+            seq.insert(index, c);
+            return true;
+        }
+        return false;
+    }
+
+    static bool removeAt(ComplexSequence& seq, int index) {
+        if (index >= 0 && index < static_cast<int>(seq.size())) {
+            seq.erase(index);
+            return true;
+        }
+        return false;
+    }
     
+    // 去重：保留每个元素第一次出现的位置，与之前保留下来的某个元素相等的元素被删除。
+    // 保留下来的前缀 [0, kept) 边构造边加入哈希索引，整体期望 O(n)，且不改变元素的相对次序
     static void makeUnique(std::vector<Complex>& vec) {
-        std::sort(vec.begin(), vec.end());
-        auto last = std::unique(vec.begin(), vec.end());
-        vec.erase(last, vec.end());
+        ComplexHashIndex index;
+        index.attach(vec, vec.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < vec.size(); ++i) {
+            if (index.find(vec[i]) >= 0) continue;
+            vec[kept] = vec[i];
+            index.add(kept++);
+        }
+        vec.resize(kept);
+    }
+};
+
+// 预计算的排序键：按 (|z|^2, 实部, 原下标) 排序。
+// 与 operator< 相比省去了每次比较的两次开方；原下标作为最后的比较项，结果确定且稳定。
+// 只有模相差不足 1e-9 的不同元素，两者的先后才可能不同(operator< 此时按实部比较)
+struct ComplexSortKey {
+    double magSq;
+    double real;
+    size_t index;
+
+    bool operator<(const ComplexSortKey& other) const {
+        if (magSq != other.magSq) return magSq < other.magSq;
+        if (real != other.real) return real < other.real;
+        return index < other.index;
     }
 };
 
@@ -118,8 +755,112 @@ public:
         mergeSort(vec, mid + 1, right);
         merge(vec, left, mid, right);
     }
+
+    // 自底向上归并：整个排序只分配一块辅助缓冲区；naturalRuns 为真时先利用天然有序段，
+    // 顺序/逆序输入接近线性。排序稳定
+    static void bottomUpSort(std::vector<Complex>& vec, bool naturalRuns = false) {
+        bottomUpMergeSort(vec, std::less<Complex>(), naturalRuns);
+    }
+
+    // 装饰-排序-还原：每个元素只计算一次键，对 (键, 下标) 排序后按下标重排。
+    // useRadix 为真时对键的位模式做 LSD 基数排序，否则用 std::sort
+    static void keySort(std::vector<Complex>& vec, bool useRadix = false) {
+        std::vector<ComplexSortKey> keys = makeKeys(vec, 1);
+        sortKeys(keys, useRadix);
+        applyKeys(vec, keys, 1);
+    }
+
+    // 并行排序：键的计算、排序、按键重排都分给 threads 个线程。
+    // 比较的是 (模平方, 实部, 下标) 这一全序，而 operator< 的模容差不构成严格弱序，
+    // 因此结果与 keySort 逐元素相同，与线程数无关
+    static void parallelMergeSort(std::vector<Complex>& vec, unsigned threads = ParallelSort::defaultThreads()) {
+        std::vector<ComplexSortKey> keys = makeKeys(vec, threads);
+        ParallelSort::mergeSort(keys, std::less<ComplexSortKey>(), threads);
+        applyKeys(vec, keys, threads);
+    }
+
+    static void parallelSampleSort(std::vector<Complex>& vec, unsigned threads = ParallelSort::defaultThreads()) {
+        std::vector<ComplexSortKey> keys = makeKeys(vec, threads);
+        ParallelSort::sampleSort(keys, std::less<ComplexSortKey>(), threads);
+        applyKeys(vec, keys, threads);
+    }
+
+    static void sortKeys(std::vector<ComplexSortKey>& keys, bool useRadix = false) {
+        if (useRadix) {
+            radixSortKeys(keys);
+        } else {
+            std::sort(keys.begin(), keys.end());
+        }
+    }
     
 private:
+    static std::vector<ComplexSortKey> makeKeys(const std::vector<Complex>& vec, unsigned threads) {
+        std::vector<ComplexSortKey> keys(vec.size());
+        ParallelSort::forChunks(vec.size(), threads, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                double re = vec[i].getReal(), im = vec[i].getImag();
+                keys[i] = {re * re + im * im, re, i};
+            }
+        });
+        return keys;
+    }
+
+    static void applyKeys(std::vector<Complex>& vec, const std::vector<ComplexSortKey>& keys, unsigned threads) {
+        std::vector<Complex> sorted(vec.size());
+        ParallelSort::forChunks(keys.size(), threads, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) sorted[i] = vec[keys[i].index];
+        });
+        vec.swap(sorted);
+    }
+
+    // double 的位模式映射为无符号整数，使整数大小顺序与浮点数顺序一致
+    static unsigned long long orderedBits(double value) {
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits >> 63) ? ~bits : (bits | 0x8000000000000000ULL);
+    }
+
+    // 按模平方的位模式做 LSD 基数排序，分 6 趟、每趟 11 位，所有元素落在同一个桶的趟次直接跳过。
+    // 每趟都是稳定的计数排序，模平方相同的元素保持原有(下标)顺序；
+    // 其中实部不同的少数情形(如共轭复数)最后在各自的小段内按完整的键补排
+    static void radixSortKeys(std::vector<ComplexSortKey>& keys) {
+        struct Item { unsigned long long bits; size_t index; };
+        constexpr int BITS = 11, BUCKETS = 1 << BITS, PASSES = (64 + BITS - 1) / BITS;
+
+        const size_t n = keys.size();
+        if (n < 2) return;
+        std::vector<Item> items(n), buffer(n);
+        for (size_t i = 0; i < n; ++i) items[i] = {orderedBits(keys[i].magSq), i};
+
+        std::vector<size_t> count(BUCKETS);
+        for (int pass = 0; pass < PASSES; ++pass) {
+            const int shift = pass * BITS;
+            std::fill(count.begin(), count.end(), 0);
+            for (const Item& item : items) count[(item.bits >> shift) & (BUCKETS - 1)]++;
+            if (count[(items[0].bits >> shift) & (BUCKETS - 1)] == n) continue;
+
+            size_t offset = 0;
+            for (auto& c : count) {
+                size_t start = offset;
+                offset += c;
+                c = start;
+            }
+            for (const Item& item : items) buffer[count[(item.bits >> shift) & (BUCKETS - 1)]++] = item;
+            items.swap(buffer);
+        }
+
+        std::vector<ComplexSortKey> sorted(n);
+        for (size_t i = 0; i < n; ++i) sorted[i] = keys[items[i].index];
+        for (size_t begin = 0, end; begin < n; begin = end) {
+            end = begin + 1;
+            while (end < n && sorted[end].magSq == sorted[begin].magSq) end++;
+            if (end - begin > 1 && !std::is_sorted(sorted.begin() + begin, sorted.begin() + end)) {
+                std::sort(sorted.begin() + begin, sorted.begin() + end);
+            }
+        }
+        keys.swap(sorted);
+    }
+
     static void merge(std::vector<Complex>& vec, int left, int mid, int right) {
         std::vector<Complex> leftVec(vec.begin() + left, vec.begin() + mid + 1);
         std::vector<Complex> rightVec(vec.begin() + mid + 1, vec.begin() + right + 1);
@@ -138,33 +879,197 @@ private:
     }
 };
 
+// 只读视图：指向 MagnitudeIndex 内部按模有序的元素，不拷贝；索引被修改后失效
+struct ComplexView {
+    const Complex* first = nullptr;
+    size_t count = 0;
+
+    const Complex* begin() const { return first; }
+    const Complex* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Complex& operator[](size_t i) const { return first[i]; }
+    std::vector<Complex> toVector() const { return std::vector<Complex>(begin(), end()); }
+};
+
+// 模索引：按 (模平方, 实部, 下标) 排好序的元素副本，建立一次后每个 [minMag, maxMag)
+// 查询只需两次二分查找，结果次序与 RangeSearch::search 的全表扫描相同。
+// insert/removeAt 在修改原向量的同时就地维护索引，代价与 std::vector 的插入删除同为 O(n)
+class MagnitudeIndex {
+private:
+    std::vector<double> magSq;
+    std::vector<size_t> positions;     // 元素在原向量中的下标
+    std::vector<Complex> elements;
+
+public:
+    MagnitudeIndex() = default;
+
+    explicit MagnitudeIndex(const std::vector<Complex>& vec) {
+        build(vec);
+    }
+
+    void build(const std::vector<Complex>& vec) {
+        std::vector<ComplexSortKey> keys(vec.size());
+        for (size_t i = 0; i < vec.size(); ++i) {
+            double re = vec[i].getReal(), im = vec[i].getImag();
+            keys[i] = {re * re + im * im, re, i};
+        }
+        SortAlgorithms::sortKeys(keys, true);
+
+        magSq.resize(keys.size());
+        positions.resize(keys.size());
+        elements.resize(keys.size());
+        for (size_t k = 0; k < keys.size(); ++k) {
+            magSq[k] = keys[k].magSq;
+            positions[k] = keys[k].index;
+            elements[k] = vec[keys[k].index];
+        }
+    }
+
+    size_t size() const { return elements.size(); }
+
+    ComplexView query(double minMag, double maxMag) const {
+        size_t first = lowerBound(minMag);
+        size_t last = std::max(first, lowerBound(maxMag));
+        return {elements.data() + first, last - first};
+    }
+
+    bool insert(std::vector<Complex>& vec, int index, const Complex& c) {
+        if (!ComplexVectorOperations::insert(vec, index, c)) return false;
+        for (auto& position : positions) {
+            if (position >= static_cast<size_t>(index)) position++;
+        }
+        double sq = c.getReal() * c.getReal() + c.getImag() * c.getImag();
+        size_t k = locate(sq, c.getReal(), index);
+        magSq.insert(magSq.begin() + k, sq);
+        positions.insert(positions.begin() + k, index);
+        elements.insert(elements.begin() + k, c);
+        return true;
+    }
+
+    bool removeAt(std::vector<Complex>& vec, int index) {
+        if (index < 0 || index >= static_cast<int>(vec.size())) return false;
+        const Complex& c = vec[index];
+        size_t k = locate(c.getReal() * c.getReal() + c.getImag() * c.getImag(), c.getReal(), index);
+        magSq.erase(magSq.begin() + k);
+        positions.erase(positions.begin() + k);
+        elements.erase(elements.begin() + k);
+        for (auto& position : positions) {
+            if (position > static_cast<size_t>(index)) position--;
+        }
+        return ComplexVectorOperations::removeAt(vec, index);
+    }
+
+private:
+    // 第一个模不小于 mag 的位置；模按 RangeSearch 相同的方式由模平方开方得到
+    size_t lowerBound(double mag) const {
+        return std::partition_point(magSq.begin(), magSq.end(),
+                                    [mag](double sq) { return std::sqrt(sq) < mag; }) - magSq.begin();
+    }
+
+    // 第一个键不小于 (sq, real, position) 的位置
+    size_t locate(double sq, double real, size_t position) const {
+        size_t lo = 0, hi = magSq.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            ComplexSortKey key = {magSq[mid], elements[mid].getReal(), positions[mid]};
+            if (key < ComplexSortKey{sq, real, position}) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+};
+
 class RangeSearch {
 public:
+    // 每个元素只算一次模平方：既用于区间判断，也直接作为排序键
     static std::vector<Complex> search(const std::vector<Complex>& vec, double minMag, double maxMag) {
+        std::vector<ComplexSortKey> keys;
+        for (size_t i = 0; i < vec.size(); ++i) {
+            double magSq = vec[i].getReal() * vec[i].getReal() + vec[i].getImag() * vec[i].getImag();
+            double mag = std::sqrt(magSq);
+            if (mag >= minMag && mag < maxMag) keys.push_back({magSq, vec[i].getReal(), i});
+        }
+        SortAlgorithms::sortKeys(keys);
+
         std::vector<Complex> result;
-        std::copy_if(vec.begin(), vec.end(), std::back_inserter(result),
-            [minMag, maxMag](const Complex& c) {
-                double mag = c.magnitude();
-                return mag >= minMag && mag < maxMag;
-            });
-        std::sort(result.begin(), result.end());
+        result.reserve(keys.size());
+        for (const auto& key : keys) result.push_back(vec[key.index]);
+        return result;
+    }
+
+    // SoA 版本：模由向量化内核批量计算，排序同样使用预计算键
+    static std::vector<Complex> search(const ComplexSoA& soa, double minMag, double maxMag) {
+        std::vector<double> mags;
+        std::vector<size_t> indices = soa.filterByMagnitude(minMag, maxMag, &mags);
+
+        const double* re = soa.realData();
+        const double* im = soa.imagData();
+        std::vector<ComplexSortKey> keys(indices.size());
+        for (size_t k = 0; k < keys.size(); ++k) {
+            size_t i = indices[k];
+            keys[k] = {re[i] * re[i] + im[i] * im[i], re[i], i};
+        }
+        SortAlgorithms::sortKeys(keys);
+
+        std::vector<Complex> result;
+        result.reserve(keys.size());
+        for (const auto& key : keys) result.push_back(soa[key.index]);
         return result;
     }
+
+    // 索引版本：两次二分查找，返回指向索引内部的视图
+    static ComplexView search(const MagnitudeIndex& index, double minMag, double maxMag) {
+        return index.query(minMag, maxMag);
+    }
 };
 
+// 排序计时，建立在共享的 Benchmark 之上：输入在计时区外复制，预热后重复多次取中位数，
+// 统计量与 CSV/JSON 输出都由 Benchmark 负责；排序算法以可调用对象 sort(vec) 传入
 class PerformanceTimer {
 public:
-    static double measureSortTime(std::vector<Complex> vec, const std::string& sortType) {
-        clock_t start = clock();
-        
-        if (sortType == "bubble") {
-            SortAlgorithms::bubbleSort(vec);
-        } else if (sortType == "merge") {
-            SortAlgorithms::mergeSort(vec, 0, vec.size() - 1);
+    // output 保存最后一次试验的排序结果，供调用方核对
+    template<typename Sort>
+    static const BenchmarkResult& measureSort(Benchmark& bench, const std::string& name, const std::vector<Complex>& input,
+                                              std::vector<Complex>& output, Sort sort) {
+        return bench.run(name, [&] { output = input; }, [&] { sort(output); });
+    }
+
+    template<typename Sort>
+    static double measureSortTime(Benchmark& bench, const std::string& name, const std::vector<Complex>& input, Sort sort) {
+        std::vector<Complex> output;
+        return measureSort(bench, name, input, output, sort).median;
+    }
+
+    // 强扩展性：问题规模不变，线程数从 1 翻倍到 maxThreads，调用 sort(vec, threads)；
+    // 报告中位耗时、加速比、并行效率，并逐元素核对结果与串行 keySort 相同
+    template<typename ParallelSortFunction>
+    static void reportStrongScaling(Benchmark& bench, const std::string& name, const std::vector<Complex>& vec,
+                                    ParallelSortFunction sort, unsigned maxThreads) {
+        std::vector<Complex> reference = vec;
+        SortAlgorithms::keySort(reference);
+
+        std::cout << name << ":\n";
+        double base = 0.0;
+        std::vector<Complex> sorted;
+        for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+            double seconds = measureSort(bench, name + "/" + std::to_string(vec.size()) + "/t" + std::to_string(threads),
+                                         vec, sorted, [&](std::vector<Complex>& v) { sort(v, threads); }).median;
+            if (threads == 1) base = seconds;
+            std::cout << "  " << std::setw(3) << threads << " 线程: " << seconds << "s  加速比 " << base / seconds
+                      << "x  效率 " << 100.0 * base / seconds / threads << "%"
+                      << (identical(sorted, reference) ? "" : "  [与串行结果不一致]") << "\n";
+            if (threads >= maxThreads) break;
         }
-        
-        clock_t end = clock();
-        return double(end - start) / CLOCKS_PER_SEC;
+    }
+
+private:
+    static bool identical(const std::vector<Complex>& a, const std::vector<Complex>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].getReal() != b[i].getReal() || a[i].getImag() != b[i].getImag()) return false;
+        }
+        return true;
     }
 };
 
@@ -177,7 +1082,358 @@ void printVector(const std::vector<Complex>& vec, const std::string& title) {
     std::cout << std::endl;
 }
 
-int main() {
+// 计时辅助：返回 body 执行的墙钟时间(秒)
+template<typename Body>
+double timeSeconds(Body&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// 数据生成：原先逐个调用 mt19937 的写法 vs 分块并行的 xoshiro256**；同时核对不同线程数的结果相同
+void runGeneratorBenchmark(size_t size, unsigned threads) {
+    std::cout << "\n--- 数据生成: " << size << " 个元素 ---" << std::endl;
+    std::vector<Complex> legacy;
+    double legacyTime = timeSeconds([&] {
+        std::mt19937 gen(DataGenerator::DEFAULT_SEED);
+        std::uniform_real_distribution<double> dis(-10.0, 10.0);
+        legacy.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            if (i % 5 == 0) legacy.emplace_back(1.5, 2.5);
+            else legacy.emplace_back(dis(gen), dis(gen));
+        }
+    });
+    legacy = std::vector<Complex>();
+
+    auto make = [](Xoshiro256& rng, size_t i) {
+        if (i % 5 == 0) return Complex(1.5, 2.5);
+        double re = rng.uniform(-10.0, 10.0);
+        return Complex(re, rng.uniform(-10.0, 10.0));
+    };
+    std::vector<Complex> serial, parallel;
+    double serialTime = timeSeconds([&] { serial = DataGenerator::generate<Complex>(size, DataGenerator::DEFAULT_SEED, make, 1); });
+    double parallelTime = timeSeconds([&] {
+        parallel = DataGenerator::generate<Complex>(size, DataGenerator::DEFAULT_SEED, make, threads);
+    });
+    bool same = true;
+    for (size_t i = 0; i < size && same; ++i) {
+        same = serial[i].getReal() == parallel[i].getReal() && serial[i].getImag() == parallel[i].getImag();
+    }
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "mt19937 逐个生成:     " << legacyTime << "s\n";
+    std::cout << "xoshiro256** 单线程:  " << serialTime << "s  加速比 " << legacyTime / serialTime << "x\n";
+    std::cout << "xoshiro256** " << threads << " 线程: " << parallelTime << "s  加速比 " << legacyTime / parallelTime
+              << "x" << (same ? "" : "  [与单线程结果不一致]") << "\n";
+}
+
+void runSoABenchmark(size_t size) {
+    std::cout << "\n--- SoA vs std::vector<Complex>: " << size << " 个元素 ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    ComplexSoA soa(vec);
+    std::vector<double> out(size);
+
+    double aosMag = timeSeconds([&] {
+        for (size_t i = 0; i < size; ++i) out[i] = vec[i].magnitude();
+    });
+    double soaMag = timeSeconds([&] { soa.magnitudes(out.data()); });
+    double aosSq = timeSeconds([&] {
+        for (size_t i = 0; i < size; ++i) out[i] = vec[i].getReal() * vec[i].getReal() + vec[i].getImag() * vec[i].getImag();
+    });
+    double soaSq = timeSeconds([&] { soa.squaredMagnitudes(out.data()); });
+
+    Complex absent(100.0, 100.0);
+    int aosIndex = 0, soaIndex = 0;
+    double aosFind = timeSeconds([&] { aosIndex = ComplexVectorOperations::find(vec, absent); });
+    double soaFind = timeSeconds([&] { soaIndex = soa.find(absent); });
+
+    std::vector<Complex> aosRange, soaRange;
+    double aosSearch = timeSeconds([&] { aosRange = RangeSearch::search(vec, 2.0, 5.0); });
+    double soaSearch = timeSeconds([&] { soaRange = RangeSearch::search(soa, 2.0, 5.0); });
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "批量求模:     AoS " << aosMag << "s  SoA " << soaMag << "s  加速比 " << aosMag / soaMag << "x\n";
+    std::cout << "批量模平方:   AoS " << aosSq << "s  SoA " << soaSq << "s  加速比 " << aosSq / soaSq << "x\n";
+    std::cout << "查找(不存在): AoS " << aosFind << "s  SoA " << soaFind << "s  加速比 " << aosFind / soaFind
+              << "x" << (aosIndex == soaIndex ? "" : "  [结果不一致]") << "\n";
+    std::cout << "区间查找:     AoS " << aosSearch << "s  SoA " << soaSearch << "s  加速比 " << aosSearch / soaSearch
+              << "x" << (aosRange == soaRange ? "" : "  [结果不一致]") << "\n";
+}
+
+void runSortBenchmark(size_t size, Benchmark& bench) {
+    std::cout << "\n--- 排序: " << size << " 个元素 ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    const std::string suffix = "/" + std::to_string(size);
+
+    std::vector<Complex> reference, merged, keyed, radixed, bottomUp, natural;
+    double stdSort = PerformanceTimer::measureSort(bench, "std::sort" + suffix, vec, reference,
+        [](std::vector<Complex>& v) { std::sort(v.begin(), v.end()); }).median;
+
+    std::cout << std::fixed << std::setprecision(4);
+    if (size <= 20000) {
+        double bubble = PerformanceTimer::measureSortTime(bench, "bubble" + suffix, vec,
+            [](std::vector<Complex>& v) { SortAlgorithms::bubbleSort(v); });
+        std::cout << "起泡排序:        " << bubble << "s\n";
+    }
+
+    double merge = PerformanceTimer::measureSort(bench, "merge" + suffix, vec, merged,
+        [](std::vector<Complex>& v) { SortAlgorithms::mergeSort(v, 0, v.size() - 1); }).median;
+    double keySort = PerformanceTimer::measureSort(bench, "key" + suffix, vec, keyed,
+        [](std::vector<Complex>& v) { SortAlgorithms::keySort(v); }).median;
+    double radixSort = PerformanceTimer::measureSort(bench, "radix" + suffix, vec, radixed,
+        [](std::vector<Complex>& v) { SortAlgorithms::keySort(v, true); }).median;
+
+    std::cout << "归并排序:        " << merge << "s\n";
+    double bottomUpTime = PerformanceTimer::measureSort(bench, "bottomup" + suffix, vec, bottomUp,
+        [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v); }).median;
+    std::cout << "自底向上归并:    " << bottomUpTime << "s  (相对归并 " << merge / bottomUpTime << "x)"
+              << (bottomUp == merged ? "" : "  [与归并结果不一致]") << "\n";
+    double naturalTime = PerformanceTimer::measureSort(bench, "natural" + suffix, vec, natural,
+        [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v, true); }).median;
+    std::cout << "自然归并:        " << naturalTime << "s  (相对归并 " << merge / naturalTime << "x)"
+              << (natural == merged ? "" : "  [与归并结果不一致]") << "\n";
+
+    // 顺序、逆序输入：自然归并只需识别出一个有序段
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<Complex> input = reference;
+        if (pass == 1) std::reverse(input.begin(), input.end());
+        const std::string order = pass == 0 ? "/ordered" : "/reversed";
+        std::vector<Complex> b, c;
+        double mergeTime = PerformanceTimer::measureSortTime(bench, "merge" + order + suffix, input,
+            [](std::vector<Complex>& v) { SortAlgorithms::mergeSort(v, 0, v.size() - 1); });
+        double bottomTime = PerformanceTimer::measureSort(bench, "bottomup" + order + suffix, input, b,
+            [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v); }).median;
+        double runTime = PerformanceTimer::measureSort(bench, "natural" + order + suffix, input, c,
+            [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v, true); }).median;
+        std::cout << (pass == 0 ? "顺序输入" : "逆序输入") << ": 归并 " << mergeTime << "s  自底向上 " << bottomTime
+                  << "s  自然归并 " << runTime << "s  (相对归并 " << mergeTime / runTime << "x)"
+                  << (b == c ? "" : "  [结果不一致]") << "\n";
+    }
+    std::cout << "std::sort:       " << stdSort << "s\n";
+    // 与 operator< 的顺序只可能在模相差不足 1e-9 的元素之间不同
+    size_t differ = 0;
+    bool withinEpsilon = true;
+    for (size_t i = 0; i < size; ++i) {
+        if (keyed[i] == reference[i]) continue;
+        differ++;
+        withinEpsilon &= std::abs(keyed[i].magnitude() - reference[i].magnitude()) < 1e-9;
+    }
+    std::cout << "预计算键+std::sort: " << keySort << "s  (相对归并 " << merge / keySort << "x, 相对 std::sort "
+              << stdSort / keySort << "x)  与 std::sort 次序不同 " << differ << " 处"
+              << (withinEpsilon ? "(均在模容差内)" : "  [超出模容差!]") << "\n";
+    std::cout << "预计算键+基数排序:  " << radixSort << "s  (相对归并 " << merge / radixSort << "x, 相对 std::sort "
+              << stdSort / radixSort << "x)" << (radixed == keyed ? "" : "  [与比较排序结果不一致]") << "\n";
+}
+
+void runParallelSortBenchmark(size_t size, unsigned maxThreads, Benchmark& bench) {
+    std::cout << "\n--- 并行排序强扩展性: " << size << " 个元素, 至多 " << maxThreads << " 线程 ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    std::cout << std::fixed << std::setprecision(4);
+    PerformanceTimer::reportStrongScaling(bench, "parallel-merge", vec,
+        [](std::vector<Complex>& v, unsigned threads) { SortAlgorithms::parallelMergeSort(v, threads); }, maxThreads);
+    PerformanceTimer::reportStrongScaling(bench, "sample", vec,
+        [](std::vector<Complex>& v, unsigned threads) { SortAlgorithms::parallelSampleSort(v, threads); }, maxThreads);
+}
+
+// 混合负载：每轮在随机位置做一批插入/删除，再完整扫描一遍求模平方和
+void runSequenceBenchmark(size_t size, int edits, int scans) {
+    std::cout << "\n--- 分块序列 vs std::vector: " << size << " 个元素, " << edits << " 次插入/删除, "
+              << scans << " 次扫描 ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    ComplexSequence seq(vec);
+
+    std::mt19937 gen(11);
+    std::vector<std::pair<int, double>> ops(edits);      // (位置的随机种子, 正数表示插入)
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    for (auto& op : ops) op = {static_cast<int>(gen() & 0x7fffffff), unit(gen) - 0.5};
+
+    auto run = [&](auto& container, double& editTime, double& scanTime) {
+        double checksum = 0.0;
+        int perRound = edits / scans;
+        for (int round = 0; round < scans; ++round) {
+            editTime += timeSeconds([&] {
+                for (int e = round * perRound; e < (round + 1) * perRound; ++e) {
+                    int n = static_cast<int>(container.size());
+                    if (ops[e].second > 0 || n == 0) {
+                        ComplexVectorOperations::insert(container, ops[e].first % (n + 1), Complex(ops[e].second, 1.0));
+                    } else {
+                        ComplexVectorOperations::removeAt(container, ops[e].first % n);
+                    }
+                }
+            });
+            scanTime += timeSeconds([&] {
+                for (const auto& c : container) checksum += c.getReal() * c.getReal() + c.getImag() * c.getImag();
+            });
+        }
+        return checksum;
+    };
+
+    double vecEdit = 0, vecScan = 0, seqEdit = 0, seqScan = 0;
+    double vecSum = run(vec, vecEdit, vecScan);
+    double seqSum = run(seq, seqEdit, seqScan);
+    double chunkSum = 0.0, finalSum = 0.0;
+    double chunkScan = timeSeconds([&] {
+        seq.forEachChunk([&](const Complex* data, size_t count) {
+            for (size_t i = 0; i < count; ++i) chunkSum += data[i].getReal() * data[i].getReal() + data[i].getImag() * data[i].getImag();
+        });
+    });
+    for (const auto& c : vec) finalSum += c.getReal() * c.getReal() + c.getImag() * c.getImag();
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "std::vector:  插入/删除 " << vecEdit << "s  扫描 " << vecScan << "s  合计 " << vecEdit + vecScan << "s\n";
+    std::cout << "分块序列:     插入/删除 " << seqEdit << "s  扫描 " << seqScan << "s  合计 " << seqEdit + seqScan
+              << "s  (加速比 " << (vecEdit + vecScan) / (seqEdit + seqScan) << "x)"
+              << (vecSum == seqSum && chunkSum == finalSum && seq.toVector() == vec ? "" : "  [结果不一致]") << "\n";
+    std::cout << "单次扫描:     std::vector " << vecScan / scans << "s  分块序列(迭代器) " << seqScan / scans
+              << "s  分块序列(逐块) " << chunkScan << "s\n";
+}
+
+void runHashBenchmark(size_t size) {
+    std::cout << "\n--- 哈希查找与去重: " << size << " 个元素(每 5 个中有一个 1.5+2.5i) ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    std::cout << std::fixed << std::setprecision(4);
+
+    ComplexHashIndex index;
+    double buildTime = timeSeconds([&] { index.build(vec); });
+    std::cout << "建立哈希索引: " << buildTime << "s\n";
+
+    // 查询一半取自向量中的元素(含大量重复的 1.5+2.5i)，一半是扰动后不存在的值
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+    std::vector<Complex> targets;
+    for (int q = 0; q < 1000; ++q) {
+        const Complex& c = vec[pick(gen)];
+        targets.push_back(q % 2 ? c : Complex(c.getReal() + 1e-6, c.getImag()));
+    }
+
+    std::vector<int> hashed(targets.size()), scanned(targets.size());
+    double hashTime = timeSeconds([&] {
+        for (size_t q = 0; q < targets.size(); ++q) hashed[q] = ComplexVectorOperations::find(index, targets[q]);
+    });
+    const size_t scans = 20;
+    double scanTime = timeSeconds([&] {
+        for (size_t q = 0; q < scans; ++q) scanned[q] = ComplexVectorOperations::find(vec, targets[q]);
+    });
+    bool same = std::equal(scanned.begin(), scanned.begin() + scans, hashed.begin());
+    std::cout << "哈希查找:     平均 " << hashTime / targets.size() * 1e9 << "ns/次\n";
+    std::cout << "线性查找:     平均 " << scanTime / scans * 1e9 << "ns/次  加速比 "
+              << (scanTime / scans) / (hashTime / targets.size()) << "x" << (same ? "" : "  [结果不一致]") << "\n";
+
+    auto sorted = vec;
+    double sortTime = timeSeconds([&] {
+        SortAlgorithms::keySort(sorted);
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    });
+    auto unique = vec;
+    double uniqueTime = timeSeconds([&] { ComplexVectorOperations::makeUnique(unique); });
+    std::cout << "排序去重:     " << sortTime << "s  剩余 " << sorted.size() << "\n";
+    std::cout << "哈希去重:     " << uniqueTime << "s  剩余 " << unique.size() << "  加速比 " << sortTime / uniqueTime
+              << "x" << (unique.size() == sorted.size() ? "" : "  [剩余个数不一致]") << "\n";
+}
+
+void runRangeIndexBenchmark(size_t size, size_t queries) {
+    std::cout << "\n--- 模索引区间查询: " << size << " 个元素, " << queries << " 次查询 ---" << std::endl;
+    auto vec = ComplexVectorOperations::generateRandomVector(size);
+    std::cout << std::fixed << std::setprecision(4);
+
+    MagnitudeIndex index;
+    double buildTime = timeSeconds([&] { index.build(vec); });
+    std::cout << "建立索引:     " << buildTime << "s\n";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> lower(0.0, 14.0), width(0.0, 0.5);
+    std::vector<std::pair<double, double>> ranges(queries);
+    for (auto& range : ranges) {
+        range.first = lower(gen);
+        range.second = range.first + width(gen);
+    }
+
+    size_t hits = 0;
+    double indexTime = timeSeconds([&] {
+        for (const auto& range : ranges) hits += RangeSearch::search(index, range.first, range.second).size();
+    });
+    std::cout << "索引查询:     " << indexTime << "s  平均 " << indexTime / queries * 1e9 << "ns/次  命中 " << hits << "\n";
+
+    // 全表扫描太慢，只跑少数几次估计单次延迟，并顺带核对结果
+    const size_t scans = 5;
+    bool same = true;
+    double scanTime = timeSeconds([&] {
+        for (size_t q = 0; q < scans; ++q) {
+            auto scanned = RangeSearch::search(vec, ranges[q].first, ranges[q].second);
+            same &= scanned == RangeSearch::search(index, ranges[q].first, ranges[q].second).toVector();
+        }
+    });
+    std::cout << "全表扫描:     平均 " << scanTime / scans * 1e9 << "ns/次  单次加速比 "
+              << (scanTime / scans) / (indexTime / queries) << "x" << (same ? "" : "  [结果不一致]") << "\n";
+
+    // 增量维护：随机插入/删除后与重建的索引比较
+    auto small = ComplexVectorOperations::generateRandomVector(std::min(size, size_t(100000)));
+    MagnitudeIndex incremental(small);
+    const int edits = 1000;
+    std::uniform_int_distribution<> coin(0, 1);
+    double editTime = timeSeconds([&] {
+        for (int e = 0; e < edits; ++e) {
+            if (coin(gen) || small.empty()) {
+                int pos = std::uniform_int_distribution<>(0, small.size())(gen);
+                incremental.insert(small, pos, Complex(lower(gen) - 7.0, lower(gen) - 7.0));
+            } else {
+                incremental.removeAt(small, std::uniform_int_distribution<>(0, small.size() - 1)(gen));
+            }
+        }
+    });
+    MagnitudeIndex rebuilt(small);
+    bool consistent = incremental.query(0.0, 100.0).toVector() == rebuilt.query(0.0, 100.0).toVector();
+    std::cout << "增量维护:     " << small.size() << " 个元素上 " << edits << " 次插入/删除 " << editTime
+              << "s  平均 " << editTime / edits * 1e6 << "us/次" << (consistent ? "" : "  [与重建结果不一致]") << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // --bench [maxSize] [maxThreads] [--trials n] [--counters] [--csv 文件] [--json 文件]
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        BenchmarkOptions options;
+        options.trials = 3;
+        std::vector<std::string> positional;
+        std::string csvPath, jsonPath;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--trials" && i + 1 < argc) options.trials = std::stoi(argv[++i]);
+            else if (arg == "--counters") options.counters = true;
+            else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+            else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+            else positional.push_back(arg);
+        }
+        size_t maxSize = positional.size() > 0 ? std::stoull(positional[0]) : 10000000;
+        unsigned maxThreads = positional.size() > 1 ? std::stoul(positional[1]) : ParallelSort::defaultThreads();
+        if (options.counters && !PerfCounters().available()) {
+            std::cout << "硬件计数器不可用(perf_event_open 失败)，只记录时间" << std::endl;
+        }
+        Benchmark bench(options);
+
+        std::cout << "=== 复数向量性能测试 ===" << std::endl;
+        runGeneratorBenchmark(maxSize, maxThreads);
+        for (size_t size = 1000000; size <= maxSize; size *= 10) runSoABenchmark(size);
+        for (size_t size = 10000; size <= maxSize; size *= 10) runSortBenchmark(size, bench);
+        runParallelSortBenchmark(maxSize, maxThreads, bench);
+        runRangeIndexBenchmark(maxSize, 1000000);
+        runHashBenchmark(maxSize);
+        for (size_t size = 100000; size <= std::min(maxSize, size_t(1000000)); size *= 10) {
+            runSequenceBenchmark(size, 20000, 20);
+        }
+
+        std::cout << "\n--- 排序计时汇总(预热 " << options.warmup << " 次, 重复 " << options.trials << " 次) ---\n";
+        bench.printTable(std::cout);
+        if (!csvPath.empty()) {
+            std::ofstream csv(csvPath);
+            bench.writeCsv(csv);
+        }
+        if (!jsonPath.empty()) {
+            std::ofstream json(jsonPath);
+            bench.writeJson(json);
+        }
+        return 0;
+    }
+
     std::cout << "=== 复数向量操作测试 ===" << std::endl;
     
     // 测试基本操作
@@ -197,8 +1453,15 @@ int main() {
     
     ComplexVectorOperations::removeAt(vec, 0);
     printVector(vec, "删除后");
+
+    // 同一组接口也可以作用在分块序列上
+    ComplexSequence seq(vec);
+    ComplexVectorOperations::insert(seq, 2, Complex(3.0, 4.0));
+    ComplexVectorOperations::removeAt(seq, 0);
+    printVector(seq.toVector(), "分块序列插入、删除后");
+    std::cout << "分块序列查找 " << target << ": 索引=" << ComplexVectorOperations::find(seq, target) << std::endl;
     
-    auto dupVec = ComplexVectorOperations::generateRandomVector(10);
+    auto dupVec = ComplexVectorOperations::generateRandomVector(10, 7);
     printVector(dupVec, "重复向量");
     ComplexVectorOperations::makeUnique(dupVec);
     printVector(dupVec, "唯一化后");
@@ -207,29 +1470,41 @@ int main() {
     std::cout << "\n2. 排序性能比较:" << std::endl;
     auto testVec = ComplexVectorOperations::generateRandomVector(500);
     
-    std::vector<Complex> ordered = testVec;
-    std::sort(ordered.begin(), ordered.end());
-    
-    std::vector<Complex> reversed = ordered;
-    std::reverse(reversed.begin(), reversed.end());
-    
-    std::cout << std::fixed << std::setprecision(6);
-    std::cout << "起泡排序 - 顺序: " << PerformanceTimer::measureSortTime(ordered, "bubble") << "s\n";
-    std::cout << "起泡排序 - 逆序: " << PerformanceTimer::measureSortTime(reversed, "bubble") << "s\n";
-    std::cout << "起泡排序 - 随机: " << PerformanceTimer::measureSortTime(testVec, "bubble") << "s\n";
+    auto ordered = ComplexVectorOperations::generateRandomVector(500, DataGenerator::SORTED);
+    auto reversed = ComplexVectorOperations::generateRandomVector(500, DataGenerator::REVERSED);
     
-    std::cout << "归并排序 - 顺序: " << PerformanceTimer::measureSortTime(ordered, "merge") << "s\n";
-    std::cout << "归并排序 - 逆序: " << PerformanceTimer::measureSortTime(reversed, "merge") << "s\n";
-    std::cout << "归并排序 - 随机: " << PerformanceTimer::measureSortTime(testVec, "merge") << "s\n";
+    Benchmark sortBench;
+    const std::pair<const char*, const std::vector<Complex>*> inputs[] = {
+        {"ordered", &ordered}, {"reversed", &reversed}, {"random", &testVec}};
+    auto measureAll = [&](const std::string& name, auto sort) {
+        for (const auto& input : inputs) PerformanceTimer::measureSortTime(sortBench, name + "/" + input.first, *input.second, sort);
+    };
+    measureAll("bubble", [](std::vector<Complex>& v) { SortAlgorithms::bubbleSort(v); });
+    measureAll("merge", [](std::vector<Complex>& v) { SortAlgorithms::mergeSort(v, 0, v.size() - 1); });
+    measureAll("bottomup", [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v); });
+    measureAll("natural", [](std::vector<Complex>& v) { SortAlgorithms::bottomUpSort(v, true); });
+    sortBench.printTable(std::cout);
     
     // 区间查找测试
     std::cout << "\n3. 区间查找测试:" << std::endl;
-    auto searchVec = ComplexVectorOperations::generateRandomVector(15);
+    auto searchVec = ComplexVectorOperations::generateRandomVector(15, 11);
     std::sort(searchVec.begin(), searchVec.end());
     printVector(searchVec, "排序向量");
     
     auto result = RangeSearch::search(searchVec, 2.0, 5.0);
     printVector(result, "模在[2,5)的元素");
     
+    ComplexSoA searchSoA(searchVec);
+    auto soaResult = RangeSearch::search(searchSoA, 2.0, 5.0);
+    printVector(soaResult, "SoA 区间查找");
+    std::cout << "SoA 查找 " << target << ": 索引=" << searchSoA.find(target)
+              << " (AoS: " << ComplexVectorOperations::find(searchVec, target) << ")" << std::endl;
+
+    MagnitudeIndex magIndex(searchVec);
+    printVector(RangeSearch::search(magIndex, 2.0, 5.0).toVector(), "索引区间查找");
+    magIndex.insert(searchVec, 0, Complex(3.0, 0.0));
+    magIndex.removeAt(searchVec, searchVec.size() - 1);
+    printVector(RangeSearch::search(magIndex, 2.0, 5.0).toVector(), "增删后索引查找");
+    
     return 0;
 }
\ No newline at end of file
@@ -2,16 +2,33 @@
 #include <vector>
 #include <stack>
 #include <algorithm>
-#include <random>
 #include <chrono>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../common/data_generator.h"
+#include "../common/parallel_for.h"
+#include "../common/benchmark.h"
 
 class HistogramSolver {
 public:
-    static int largestRectangleArea(std::vector<int>& heights) {
+    static long long largestRectangleArea(std::vector<int>& heights) {
         if (heights.empty()) return 0;
         
         std::stack<int> stk;
-        int maxArea = 0;
+        long long maxArea = 0;
         heights.push_back(0); // 哨兵
         
         for (int i = 0; i < heights.size(); ++i) {
@@ -19,7 +36,7 @@ public:
                 int height = heights[stk.top()];
                 stk.pop();
                 int width = stk.empty() ? i : i - stk.top() - 1;
-                maxArea = std::max(maxArea, height * width);
+                maxArea = std::max(maxArea, static_cast<long long>(height) * width);
             }
             stk.push(i);
         }
@@ -29,17 +46,616 @@ public:
     }
 };
 
-class TestDataGenerator {
+// 单调栈的数组实现：栈是预先分配的连续数组，栈底放一个高度为 INT_MIN 的哨兵，
+// 弹栈循环不必判断栈空；输入只读，不再向调用者的数组追加哨兵。
+// 同一个对象反复求解时复用栈与辅助数组，稳定后不再分配内存
+class HistogramKernel {
+private:
+    struct Bar {
+        int height;
+        size_t start;
+    };
+
+    std::vector<Bar> stack;
+    std::vector<size_t> left;
+    std::vector<size_t> right;
+
+    Bar* reserve(size_t n) {
+        if (stack.size() < n + 1) stack.resize(n + 1);
+        stack[0] = {INT_MIN, 0};
+        return stack.data();
+    }
+
 public:
-    static std::vector<int> generateRandomHeights(int length, int maxHeight = 10000) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, maxHeight);
-        
-        std::vector<int> heights(length);
-        for (int i = 0; i < length; ++i) {
-            heights[i] = dis(gen);
+    // heights[0, n) 的最大矩形面积，高度需大于 INT_MIN
+    long long solve(const int* heights, size_t n) {
+        Bar* stk = reserve(n);
+        size_t top = 0;
+        long long best = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const int h = heights[i];
+            size_t start = i;
+            while (stk[top].height >= h) {
+                best = std::max(best, static_cast<long long>(stk[top].height) * static_cast<long long>(i - stk[top].start));
+                start = stk[top].start;
+                --top;
+            }
+            stk[++top] = {h, start};
+        }
+        for (; top > 0; --top) {
+            best = std::max(best, static_cast<long long>(stk[top].height) * static_cast<long long>(n - stk[top].start));
+        }
+        return best;
+    }
+
+    long long solve(const std::vector<int>& heights) {
+        return solve(heights.data(), heights.size());
+    }
+
+    // 先求出每根柱子向左、向右能延伸到的范围 [leftBound(i), rightBound(i))
+    // (即两侧第一个严格更矮的柱子之间)，再逐个计算面积。两遍扫描都只存下标，
+    // 求解之后这两个数组仍可通过 leftBound / rightBound 读取
+    long long solveWithBounds(const int* heights, size_t n) {
+        left.resize(n);
+        right.resize(n);
+        Bar* stk = reserve(n);
+        size_t top = 0;
+        for (size_t i = 0; i < n; ++i) {
+            while (stk[top].height >= heights[i]) --top;
+            left[i] = top ? stk[top].start + 1 : 0;
+            stk[++top] = {heights[i], i};
+        }
+        top = 0;
+        for (size_t i = n; i-- > 0;) {
+            while (stk[top].height >= heights[i]) --top;
+            right[i] = top ? stk[top].start : n;
+            stk[++top] = {heights[i], i};
+        }
+        long long best = 0;
+        for (size_t i = 0; i < n; ++i) {
+            best = std::max(best, static_cast<long long>(heights[i]) * static_cast<long long>(right[i] - left[i]));
+        }
+        return best;
+    }
+
+    size_t leftBound(size_t i) const { return left[i]; }
+    size_t rightBound(size_t i) const { return right[i]; }
+
+    // 批量求解：第 k 个柱状图为 heights[offsets[k], offsets[k + 1])，面积写入 results[k]，
+    // 所有柱状图共用同一个栈
+    void solveBatch(const int* heights, const size_t* offsets, size_t count, long long* results) {
+        for (size_t k = 0; k < count; ++k) {
+            results[k] = solve(heights + offsets[k], offsets[k + 1] - offsets[k]);
+        }
+    }
+};
+
+// 子区间最大矩形查询：对静态的高度数组预处理一次，之后回答任意 heights[l..r] 内的最大矩形。
+// 设 m 为区间内最左的最小值，答案是以下三者的最大值：
+//   整个区间高为 h[m] 的矩形；
+//   [l, m) 内的矩形：沿“右侧第一个不高于它的柱子”(next)从 l 走到 m，途经的每根柱子 x 贡献
+//     [l, next[x]) 上高为 h[x] 的矩形，以及完全落在 (x, next[x]) 内的最大矩形(预先算好)；
+//   (m, r] 内的矩形：沿“左侧第一个不高于它的柱子”(prev)从 r 走到 m，对称处理。
+// m 由按块划分的稀疏表(RMQ)求出。每步只需读一个 16 字节的节点，随机数据上途经的柱子数
+// 期望为 O(log n)；单调数据上退化为区间长度，与直接跑单调栈同阶
+class RangeRectangleQuery {
+private:
+    static constexpr size_t BLOCK = 32;
+
+    // 向右走时访问的字段放在一起，一次缓存行读取即可
+    struct Step {
+        uint32_t link;             // next[x] 或 prev[x]，不存在时为 n 或 0(查询不会走到)
+        int height;
+        long long inner;           // 完全落在 (x, next[x]) 或 (prev[x], x) 内的最大矩形
+    };
+
+    std::vector<int> heights;
+    std::vector<Step> forward;
+    std::vector<Step> backward;
+    std::vector<uint32_t> blockMin;    // 稀疏表，第 k 层为 2^k 个连续块中最左的最小值下标
+    size_t blocks = 0;
+
+    uint32_t better(uint32_t a, uint32_t b) const {
+        return heights[b] < heights[a] ? b : a;
+    }
+
+    uint32_t scan(size_t l, size_t r) const {
+        uint32_t best = static_cast<uint32_t>(l);
+        for (size_t i = l + 1; i <= r; ++i) {
+            if (heights[i] < heights[best]) best = static_cast<uint32_t>(i);
+        }
+        return best;
+    }
+
+    // 单调栈一遍求出 link 与 inner：弹出的柱子把自身的矩形和它右侧(已弹出部分)的最大值交给新的栈顶
+    static void link(const std::vector<int>& h, const std::vector<long long>& area, std::vector<Step>& steps,
+                     bool reverse) {
+        const size_t n = h.size();
+        steps.resize(n);
+        std::vector<uint32_t> stack;
+        std::vector<long long> after;
+        for (size_t k = 0; k < n; ++k) {
+            const size_t i = reverse ? n - 1 - k : k;
+            long long carried = 0;
+            while (!stack.empty() && h[stack.back()] >= h[i]) {
+                uint32_t e = stack.back();
+                steps[e] = {static_cast<uint32_t>(i), h[e], std::max(after.back(), carried)};
+                carried = std::max({carried, after.back(), area[e]});
+                stack.pop_back();
+                after.pop_back();
+            }
+            if (!after.empty()) after.back() = std::max(after.back(), carried);
+            stack.push_back(static_cast<uint32_t>(i));
+            after.push_back(0);
+        }
+        while (!stack.empty()) {
+            uint32_t e = stack.back();
+            steps[e] = {static_cast<uint32_t>(reverse ? 0 : n), h[e], after.back()};
+            long long carried = std::max(after.back(), area[e]);
+            stack.pop_back();
+            after.pop_back();
+            if (!after.empty()) after.back() = std::max(after.back(), carried);
+        }
+    }
+
+public:
+    explicit RangeRectangleQuery(std::vector<int> values) : heights(std::move(values)) {
+        const size_t n = heights.size();
+        if (n >= UINT32_MAX) throw std::invalid_argument("高度个数超出 32 位下标范围");
+
+        // 每根柱子的全局最大矩形 [leftBound, rightBound)
+        HistogramKernel kernel;
+        kernel.solveWithBounds(heights.data(), n);
+        std::vector<long long> area(n);
+        for (size_t i = 0; i < n; ++i) {
+            area[i] = static_cast<long long>(heights[i]) * static_cast<long long>(kernel.rightBound(i) - kernel.leftBound(i));
+        }
+        link(heights, area, forward, false);
+        link(heights, area, backward, true);
+
+        blocks = (n + BLOCK - 1) / BLOCK;
+        size_t levels = 1;
+        while ((size_t(1) << levels) <= blocks) levels++;
+        blockMin.resize(levels * blocks);
+        for (size_t b = 0; b < blocks; ++b) blockMin[b] = scan(b * BLOCK, std::min(n, (b + 1) * BLOCK) - 1);
+        for (size_t k = 1; k < levels; ++k) {
+            const uint32_t* prev = &blockMin[(k - 1) * blocks];
+            uint32_t* level = &blockMin[k * blocks];
+            for (size_t b = 0; b + (size_t(1) << k) <= blocks; ++b) {
+                level[b] = better(prev[b], prev[b + (size_t(1) << (k - 1))]);
+            }
+        }
+    }
+
+    size_t size() const { return heights.size(); }
+
+    size_t memoryBytes() const {
+        return heights.size() * sizeof(int) + (forward.size() + backward.size()) * sizeof(Step) +
+               blockMin.size() * sizeof(uint32_t);
+    }
+
+    // [l, r] 中最左的最小值下标
+    size_t argmin(size_t l, size_t r) const {
+        const size_t bl = l / BLOCK, br = r / BLOCK;
+        if (bl == br) return scan(l, r);
+        uint32_t best = scan(l, bl * BLOCK + BLOCK - 1);
+        if (bl + 1 < br) {
+            size_t count = br - bl - 1, k = 0;
+            while ((size_t(2) << k) <= count) k++;
+            const uint32_t* level = &blockMin[k * blocks];
+            best = better(best, better(level[bl + 1], level[br - (size_t(1) << k)]));
+        }
+        return better(best, scan(br * BLOCK, r));
+    }
+
+    // heights[l..r](闭区间)内的最大矩形面积
+    long long query(size_t l, size_t r) const {
+        if (l > r || r >= heights.size()) throw std::out_of_range("查询区间越界");
+        const size_t m = argmin(l, r);
+        long long best = static_cast<long long>(heights[m]) * static_cast<long long>(r - l + 1);
+        for (size_t x = l; x < m;) {
+            const Step& s = forward[x];
+            best = std::max({best, static_cast<long long>(s.height) * static_cast<long long>(s.link - l), s.inner});
+            x = s.link;
+        }
+        for (size_t y = r; y > m;) {
+            const Step& s = backward[y];
+            best = std::max({best, static_cast<long long>(s.height) * static_cast<long long>(r - s.link), s.inner});
+            y = s.link;
+        }
+        return best;
+    }
+
+    // 批量查询：各查询互不依赖，分给 threads 个线程
+    std::vector<long long> queryBatch(const std::vector<std::pair<size_t, size_t>>& ranges,
+                                      unsigned threads = hardwareThreads()) const {
+        std::vector<long long> results(ranges.size());
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, ranges.size() / 1024)));
+        parallelChunks(ranges.size(), threads, [&](unsigned, size_t begin, size_t end) {
+            for (size_t q = begin; q < end; ++q) results[q] = query(ranges[q].first, ranges[q].second);
+        });
+        return results;
+    }
+};
+
+// 矩形的位置：覆盖下标 [start, end)，高度为 height
+struct HistogramRectangle {
+    long long area = 0;
+    size_t start = 0;
+    size_t end = 0;
+    int height = 0;
+};
+
+// 流式求解：高度逐个到达，只保留单调栈，不保存历史数据。
+// 栈中每一项记录一个高度及它能向左延伸到的起点，高度严格递增，
+// 所以栈深不超过不同高度值的个数(高度有界时内存为常数)。面积用 64 位整数
+class StreamingHistogramSolver {
+private:
+    struct Bar {
+        size_t start;
+        int height;
+    };
+
+    std::vector<Bar> stack;
+    size_t position = 0;
+    size_t maxDepth = 0;
+    HistogramRectangle best;
+
+    void close(const Bar& bar, size_t end) {
+        long long area = static_cast<long long>(bar.height) * static_cast<long long>(end - bar.start);
+        if (area > best.area) best = {area, bar.start, end, bar.height};
+    }
+
+public:
+    void push(int height) {
+        size_t start = position;
+        while (!stack.empty() && stack.back().height >= height) {
+            close(stack.back(), position);
+            start = stack.back().start;
+            stack.pop_back();
+        }
+        stack.push_back({start, height});
+        maxDepth = std::max(maxDepth, stack.size());
+        position++;
+    }
+
+    void push(const int* heights, size_t count) {
+        for (size_t i = 0; i < count; ++i) push(heights[i]);
+    }
+
+    // 到目前为止的最大矩形：已出栈的最优值与仍在栈中、延伸到当前位置的矩形比较，O(栈深)
+    HistogramRectangle currentMax() const {
+        HistogramRectangle result = best;
+        for (const auto& bar : stack) {
+            long long area = static_cast<long long>(bar.height) * static_cast<long long>(position - bar.start);
+            if (area > result.area) result = {area, bar.start, position, bar.height};
+        }
+        return result;
+    }
+
+    // 输入结束：清空栈并返回最终结果，之后可以开始新的一段流
+    HistogramRectangle finish() {
+        while (!stack.empty()) {
+            close(stack.back(), position);
+            stack.pop_back();
+        }
+        HistogramRectangle result = best;
+        best = HistogramRectangle();
+        position = 0;
+        return result;
+    }
+
+    size_t count() const { return position; }
+    size_t stackDepth() const { return stack.size(); }
+    size_t maxStackDepth() const { return maxDepth; }
+
+    // 从文件读取 int32 二进制高度序列，每次读入一块，内存占用与文件大小无关
+    static HistogramRectangle solveFile(const std::string& path, StreamingHistogramSolver* solver = nullptr) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("无法打开文件: " + path);
+        StreamingHistogramSolver local;
+        StreamingHistogramSolver& s = solver ? *solver : local;
+        std::vector<int> buffer(1 << 18);
+        while (in) {
+            in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(int));
+            s.push(buffer.data(), static_cast<size_t>(in.gcount()) / sizeof(int));
+        }
+        return s.finish();
+    }
+
+    // 内存映射版本：由内核按需换页，顺序访问提示预读；非 POSIX 平台退回 solveFile
+    static HistogramRectangle solveMapped(const std::string& path, StreamingHistogramSolver* solver = nullptr) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("无法打开文件: " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("无法读取文件大小: " + path);
+        }
+        StreamingHistogramSolver local;
+        StreamingHistogramSolver& s = solver ? *solver : local;
+        size_t bytes = static_cast<size_t>(info.st_size);
+        if (bytes >= sizeof(int)) {
+            void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("内存映射失败: " + path);
+            }
+            madvise(mapped, bytes, MADV_SEQUENTIAL);
+            // 分段处理，已处理过的页及时释放，常驻内存不随文件增长
+            const size_t window = size_t(64) << 20;
+            const int* heights = static_cast<const int*>(mapped);
+            size_t total = bytes / sizeof(int);
+            for (size_t begin = 0; begin < total; begin += window / sizeof(int)) {
+                size_t count = std::min(total - begin, window / sizeof(int));
+                s.push(heights + begin, count);
+                madvise(const_cast<int*>(heights + begin), count * sizeof(int), MADV_DONTNEED);
+            }
+            munmap(mapped, bytes);
+        }
+        ::close(fd);
+        return s.finish();
+#else
+        return solveFile(path, solver);
+#endif
+    }
+};
+
+// 并行分治求解：高度均分给各线程，每段独立跑一遍单调栈。
+// 左右都被段内更矮的柱子挡住的矩形在段内就能确定；其余只有两类：
+// 段的前缀最小值(左侧可能越过段首)与段末仍在栈中的柱子(右侧可能越过段尾)。
+// 前面各段留下的栈只会被后一段的前缀最小值弹出，因此按段的次序把
+// 前缀最小值和剩余栈依次送入一个全局单调栈即可合并，结果与串行算法的最大面积相同
+class ParallelHistogramSolver {
+private:
+    // 每段至少这么多个高度，太短的段不值得开线程
+    static constexpr size_t MIN_CHUNK = 1 << 14;
+
+    struct Bar {
+        size_t start;
+        int height;
+    };
+
+    // 段的前缀最小值：出现的位置、高度，以及在段内被弹出的位置(段内最小值没有)
+    struct Minimum {
+        size_t position;
+        int height;
+        size_t end;
+    };
+
+    struct Chunk {
+        size_t begin = 0;
+        HistogramRectangle best;           // 完全在段内确定的最大矩形
+        std::vector<Minimum> minima;       // 位置递增、高度不增，最后一个是段内最小值
+        std::vector<Bar> rest;             // 段末栈中最小值之上的柱子，高度严格递增
+    };
+
+    static void consider(HistogramRectangle& best, const Bar& bar, size_t end) {
+        long long area = static_cast<long long>(bar.height) * static_cast<long long>(end - bar.start);
+        if (area > best.area) best = {area, bar.start, end, bar.height};
+    }
+
+    static Chunk scan(const int* heights, size_t begin, size_t end) {
+        Chunk chunk;
+        chunk.begin = begin;
+        std::vector<Bar> stack;
+        for (size_t i = begin; i < end; ++i) {
+            size_t start = i;
+            while (!stack.empty() && stack.back().height >= heights[i]) {
+                if (stack.size() == 1) chunk.minima.back().end = i;
+                else consider(chunk.best, stack.back(), i);
+                start = stack.back().start;
+                stack.pop_back();
+            }
+            if (stack.empty()) chunk.minima.push_back({i, heights[i], end});
+            stack.push_back({start, heights[i]});
+        }
+        if (!stack.empty()) chunk.rest.assign(stack.begin() + 1, stack.end());
+        return chunk;
+    }
+
+public:
+    static HistogramRectangle solve(const std::vector<int>& heights, unsigned threads = hardwareThreads()) {
+        return solve(heights.data(), heights.size(), threads);
+    }
+
+    static HistogramRectangle solve(const int* heights, size_t n, unsigned threads = hardwareThreads()) {
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, n / MIN_CHUNK)));
+        std::vector<Chunk> chunks(threads);
+        parallelChunks(n, threads, [&](unsigned t, size_t begin, size_t end) {
+            chunks[t] = scan(heights, begin, end);
+        });
+
+        HistogramRectangle best;
+        std::vector<Bar> stack;
+        for (const auto& chunk : chunks) {
+            if (chunk.best.area > best.area) best = chunk.best;
+            // 段首到当前前缀最小值之间的高度都不低于它，所以起点至少是段首
+            size_t start = chunk.begin;
+            for (size_t m = 0; m < chunk.minima.size(); ++m) {
+                const Minimum& minimum = chunk.minima[m];
+                while (!stack.empty() && stack.back().height >= minimum.height) {
+                    consider(best, stack.back(), minimum.position);
+                    start = stack.back().start;
+                    stack.pop_back();
+                }
+                if (m + 1 < chunk.minima.size()) consider(best, {start, minimum.height}, minimum.end);
+                else stack.push_back({start, minimum.height});
+            }
+            stack.insert(stack.end(), chunk.rest.begin(), chunk.rest.end());
+        }
+        for (const auto& bar : stack) consider(best, bar, n);
+        return best;
+    }
+};
+
+// 按行位压缩的 0/1 矩阵：每行占 wordsPerRow() 个 64 位字，第 c 列是第 c / 64 个字的第 c % 64 位，
+// 行末多出的位恒为 0。一行可以直接作为 MaximalRectangle::pushRow 的输入
+class BitMatrix {
+private:
+    size_t rowCount;
+    size_t colCount;
+    size_t words;
+    std::vector<uint64_t> bits;
+
+public:
+    BitMatrix(size_t rows, size_t cols)
+        : rowCount(rows), colCount(cols), words((cols + 63) / 64), bits(rows * words, 0) {}
+
+    size_t rows() const { return rowCount; }
+    size_t cols() const { return colCount; }
+    size_t wordsPerRow() const { return words; }
+
+    const uint64_t* row(size_t r) const { return bits.data() + r * words; }
+    uint64_t* row(size_t r) { return bits.data() + r * words; }
+
+    bool get(size_t r, size_t c) const {
+        return (row(r)[c / 64] >> (c % 64)) & 1;
+    }
+
+    void set(size_t r, size_t c, bool value = true) {
+        uint64_t mask = uint64_t(1) << (c % 64);
+        if (value) row(r)[c / 64] |= mask;
+        else row(r)[c / 64] &= ~mask;
+    }
+
+    // 把第 r 行的 [c0, c1) 列全部置 1，整字一次写入
+    void fill(size_t r, size_t c0, size_t c1) {
+        uint64_t* data = row(r);
+        while (c0 < c1 && c0 % 64) set(r, c0++);
+        for (; c0 + 64 <= c1; c0 += 64) data[c0 / 64] = ~uint64_t(0);
+        while (c0 < c1) set(r, c0++);
+    }
+
+    // 每格独立地以概率 density 为 1；按字并行生成，结果只取决于 seed
+    static BitMatrix random(size_t rows, size_t cols, double density, uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        BitMatrix matrix(rows, cols);
+        const size_t words = matrix.words;
+        const uint64_t threshold = density >= 1.0 ? UINT64_MAX : static_cast<uint64_t>(density * 0x1.0p64);
+        matrix.bits = DataGenerator::generate<uint64_t>(rows * words, seed, [=](Xoshiro256& rng, size_t i) {
+            size_t base = i % words * 64;
+            size_t count = std::min<size_t>(64, cols - base);
+            uint64_t word = 0;
+            for (size_t k = 0; k < count; ++k) word |= static_cast<uint64_t>(rng() < threshold) << k;
+            return word;
+        });
+        return matrix;
+    }
+};
+
+// 矩阵中的矩形：行 [top, bottom)，列 [left, right)
+struct MatrixRectangle {
+    long long area = 0;
+    size_t top = 0;
+    size_t left = 0;
+    size_t bottom = 0;
+    size_t right = 0;
+};
+
+// 全 1 最大子矩形：逐行累计每列向上连续 1 的个数，每一行都得到一个柱状图，
+// 以该行为底的最大全 1 矩形就是这个柱状图的最大矩形。
+// 行逐个送入 pushRow，只保留当前一行的高度，内存与行数无关
+class MaximalRectangle {
+private:
+    // 并行时每个行带至少这么多行
+    static constexpr size_t MIN_BAND_ROWS = 64;
+
+    size_t cols;
+    size_t rowIndex;
+    std::vector<int> heights;
+    StreamingHistogramSolver histogram;
+    MatrixRectangle best;
+
+public:
+    explicit MaximalRectangle(size_t columns) : cols(columns), rowIndex(0), heights(columns, 0) {}
+
+    // 从第 firstRow 行继续，initial 是第 firstRow - 1 行的各列高度
+    MaximalRectangle(size_t columns, size_t firstRow, std::vector<int> initial)
+        : cols(columns), rowIndex(firstRow), heights(std::move(initial)) {
+        heights.resize(cols, 0);
+    }
+
+    // bits 为位压缩的一行，格式同 BitMatrix::row
+    void pushRow(const uint64_t* bits) {
+        accumulate(bits, heights.data(), cols);
+        histogram.push(heights.data(), cols);
+        HistogramRectangle rect = histogram.finish();
+        if (rect.area > best.area) {
+            best = {rect.area, rowIndex + 1 - static_cast<size_t>(rect.height), rect.start, rowIndex + 1, rect.end};
+        }
+        rowIndex++;
+    }
+
+    const MatrixRectangle& result() const { return best; }
+    const std::vector<int>& columnHeights() const { return heights; }
+
+    // 用一行更新各列高度：该格为 1 则加一，否则归零
+    static void accumulate(const uint64_t* bits, int* heights, size_t cols) {
+        for (size_t base = 0; base < cols; base += 64) {
+            uint64_t word = bits[base / 64];
+            int* h = heights + base;
+            size_t count = std::min<size_t>(64, cols - base);
+            for (size_t k = 0; k < count; ++k) h[k] = (h[k] + 1) * static_cast<int>((word >> k) & 1);
+        }
+    }
+
+    // 按行带并行：先各自算出本带末行的局部高度(从带首的 0 开始累计)，
+    // 局部高度等于带高的列说明整带全 1，真实高度还要加上上一带末行的真实高度；
+    // 由此串行推出每带起始的真实高度后，各带再独立逐行求解，结果与串行完全相同
+    static MatrixRectangle solve(const BitMatrix& matrix, unsigned threads = hardwareThreads()) {
+        const size_t rows = matrix.rows(), columns = matrix.cols();
+        unsigned bands = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, rows / MIN_BAND_ROWS)));
+
+        std::vector<std::vector<int>> bottoms(bands);
+        std::vector<size_t> bandRows(bands);
+        if (bands > 1) {
+            parallelChunks(rows, bands, [&](unsigned b, size_t begin, size_t end) {
+                bandRows[b] = end - begin;
+                if (b + 1 == bands) return;
+                bottoms[b].assign(columns, 0);
+                for (size_t r = begin; r < end; ++r) accumulate(matrix.row(r), bottoms[b].data(), columns);
+            });
+        }
+
+        std::vector<std::vector<int>> carry(bands);
+        carry[0].assign(columns, 0);
+        for (unsigned b = 1; b < bands; ++b) {
+            carry[b] = std::move(bottoms[b - 1]);
+            const int full = static_cast<int>(bandRows[b - 1]);
+            for (size_t c = 0; c < columns; ++c) {
+                if (carry[b][c] == full) carry[b][c] += carry[b - 1][c];
+            }
+        }
+
+        std::vector<MatrixRectangle> results(bands);
+        parallelChunks(rows, bands, [&](unsigned b, size_t begin, size_t end) {
+            MaximalRectangle engine(columns, begin, std::move(carry[b]));
+            for (size_t r = begin; r < end; ++r) engine.pushRow(matrix.row(r));
+            results[b] = engine.result();
+        });
+
+        MatrixRectangle result;
+        for (const auto& r : results) {
+            if (r.area > result.area) result = r;
         }
+        return result;
+    }
+};
+
+class TestDataGenerator {
+public:
+    // 高度均匀分布在 [0, maxHeight]，同一 seed 总是生成相同的数据
+    static std::vector<int> generateRandomHeights(int length, int maxHeight = 10000,
+                                                  uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        return DataGenerator::uniformInts(length, 0, maxHeight, seed);
+    }
+
+    // 单调递增/递减的柱状图，是单调栈的最好与最坏情形
+    static std::vector<int> generateHeights(int length, int maxHeight, DataGenerator::Order order,
+                                            uint64_t seed = DataGenerator::DEFAULT_SEED) {
+        std::vector<int> heights = generateRandomHeights(length, maxHeight, seed);
+        DataGenerator::arrange(heights, order);
         return heights;
     }
 };
@@ -67,38 +683,377 @@ void runBasicTests() {
     
     for (size_t i = 0; i < testCases.size(); ++i) {
         std::vector<int> heights = testCases[i];
-        int result = HistogramSolver::largestRectangleArea(heights);
+        long long result = HistogramSolver::largestRectangleArea(heights);
         std::cout << "测试" << i + 1 << ": ";
         printVector(heights);
-        std::cout << " -> 面积: " << result << std::endl;
+        std::cout << " -> 面积: " << result;
+
+        StreamingHistogramSolver stream;
+        stream.push(heights.data(), heights.size());
+        HistogramRectangle rect = stream.finish();
+        HistogramKernel kernel;
+        std::cout << "  流式: [" << rect.start << ", " << rect.end << ") 高 " << rect.height
+                  << (rect.area == result && kernel.solve(heights) == result ? "" : "  [与整体求解不一致]") << std::endl;
     }
 }
 
+// 原 std::stack 实现与数组实现的对照基准：
+// 大量随机长度的小柱状图(逐个求解与批量求解)，以及随机、升序、降序的大柱状图
 void runRandomTests() {
-    std::cout << "\n=== 随机测试 ===\n";
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    for (int i = 1; i <= 10; ++i) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> lenDis(1, 1000);
-        std::uniform_int_distribution<> heightDis(0, 1000);
-        
-        int length = lenDis(gen);
-        auto heights = TestDataGenerator::generateRandomHeights(length, heightDis(gen));
-        int result = HistogramSolver::largestRectangleArea(heights);
-        
-        std::cout << "随机测试" << i << ": 长度=" << length << " -> 最大面积: " << result << std::endl;
+    std::cout << "\n=== 随机测试: std::stack 与数组实现 ===\n";
+    Benchmark bench;
+
+    const int count = 10000;
+    Xoshiro256 gen(DataGenerator::DEFAULT_SEED);
+    std::vector<std::vector<int>> small(count);
+    std::vector<int> packed;
+    std::vector<size_t> offsets(1, 0);
+    for (int i = 0; i < count; ++i) {
+        int length = static_cast<int>(gen.uniformInt(1, 1000));
+        int maxHeight = static_cast<int>(gen.uniformInt(0, 1000));
+        small[i] = TestDataGenerator::generateRandomHeights(length, maxHeight, i + 1);
+        packed.insert(packed.end(), small[i].begin(), small[i].end());
+        offsets.push_back(packed.size());
     }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    std::cout << "\n测试耗时: " << duration.count() << " ms\n";
+
+    std::vector<long long> expected(count), single(count), bounds(count), batch(count);
+    HistogramKernel kernel;
+    bench.run("std::stack/small x10000", [&] {
+        for (int i = 0; i < count; ++i) expected[i] = HistogramSolver::largestRectangleArea(small[i]);
+    });
+    bench.run("kernel/small x10000", [&] {
+        for (int i = 0; i < count; ++i) single[i] = kernel.solve(small[i]);
+    });
+    bench.run("bounds/small x10000", [&] {
+        for (int i = 0; i < count; ++i) bounds[i] = kernel.solveWithBounds(small[i].data(), small[i].size());
+    });
+    bench.run("batch/small x10000", [&] { kernel.solveBatch(packed.data(), offsets.data(), count, batch.data()); });
+    bool consistent = single == expected && bounds == expected && batch == expected;
+
+    const char* orders[] = {"random", "sorted", "reversed"};
+    for (int o = 0; o < 3; ++o) {
+        auto heights = TestDataGenerator::generateHeights(10000000, 10000, static_cast<DataGenerator::Order>(o));
+        const std::string suffix = std::string("/") + orders[o] + " 1e7";
+        long long reference = 0, fast = 0, twoPass = 0;
+        bench.run("std::stack" + suffix, [&] { reference = HistogramSolver::largestRectangleArea(heights); });
+        bench.run("kernel" + suffix, [&] { fast = kernel.solve(heights); });
+        bench.run("bounds" + suffix, [&] { twoPass = kernel.solveWithBounds(heights.data(), heights.size()); });
+        consistent = consistent && fast == reference && twoPass == reference;
+    }
+
+    bench.printTable(std::cout);
+    std::cout << (consistent ? "各实现结果一致\n" : "[各实现结果不一致]\n");
+}
+
+// 子区间查询对照：每个查询都与在子数组上重新运行单调栈的结果比较
+void runRangeQueryTests() {
+    std::cout << "\n=== 子区间最大矩形对照 ===\n";
+    int failures = 0, cases = 0;
+    HistogramKernel kernel;
+    for (int o = 0; o < 3; ++o) {
+        for (int maxHeight : {0, 5, 10000}) {
+            auto heights = TestDataGenerator::generateHeights(5000, maxHeight, static_cast<DataGenerator::Order>(o), o + 1);
+            RangeRectangleQuery engine(heights);
+            Xoshiro256 rng(maxHeight + o);
+            std::vector<std::pair<size_t, size_t>> ranges;
+            for (int q = 0; q < 2000; ++q) {
+                size_t l = rng.uniformInt(0, heights.size() - 1);
+                size_t r = q % 4 ? rng.uniformInt(l, std::min(heights.size() - 1, l + 100)) : rng.uniformInt(l, heights.size() - 1);
+                ranges.push_back({l, r});
+            }
+            std::vector<long long> answers = engine.queryBatch(ranges, 3);
+            for (size_t q = 0; q < ranges.size(); ++q) {
+                long long expected = kernel.solve(heights.data() + ranges[q].first, ranges[q].second - ranges[q].first + 1);
+                ++cases;
+                if (answers[q] != expected || engine.query(ranges[q].first, ranges[q].second) != expected) {
+                    if (++failures <= 5) {
+                        std::cout << "不一致: [" << ranges[q].first << ", " << ranges[q].second << "] 查询="
+                                  << answers[q] << " 单调栈=" << expected << "\n";
+                    }
+                }
+            }
+        }
+    }
+    std::cout << cases << " 组对照, " << failures << " 组不一致\n";
 }
 
-int main() {
+// 并行求解与串行求解逐一对照：随机、升序、降序、全相等的数据，各种线程数
+void runParallelTests() {
+    std::cout << "\n=== 并行求解对照 ===\n";
+    const DataGenerator::Order orders[] = {DataGenerator::RANDOM, DataGenerator::SORTED, DataGenerator::REVERSED};
+    const char* names[] = {"随机", "升序", "降序"};
+    int failures = 0, cases = 0;
+    for (int length : {1 << 14, 100000, 1 << 18}) {
+        for (int o = 0; o < 3; ++o) {
+            for (int maxHeight : {0, 3, 10000}) {
+                auto heights = TestDataGenerator::generateHeights(length, maxHeight, orders[o], length + o);
+                long long expected = HistogramSolver::largestRectangleArea(heights);
+                for (unsigned threads : {1u, 2u, 3u, 7u, 16u}) {
+                    HistogramRectangle rect = ParallelHistogramSolver::solve(heights, threads);
+                    long long check = static_cast<long long>(rect.height) * static_cast<long long>(rect.end - rect.start);
+                    bool covered = rect.end <= heights.size() &&
+                        std::all_of(heights.begin() + rect.start, heights.begin() + rect.end,
+                                    [&](int h) { return h >= rect.height; });
+                    ++cases;
+                    if (rect.area != expected || check != expected || !covered) {
+                        ++failures;
+                        std::cout << "不一致: 长度=" << length << " " << names[o] << " 最大高度=" << maxHeight
+                                  << " 线程=" << threads << " 并行=" << rect.area << " 串行=" << expected << "\n";
+                    }
+                }
+            }
+        }
+    }
+    std::cout << cases << " 组对照, " << failures << " 组不一致\n";
+}
+
+// 全 1 最大子矩形对照：小矩阵与 O(行² × 列) 的穷举比较，并检查不同线程数(行带划分)的结果
+void runMatrixTests() {
+    std::cout << "\n=== 全 1 最大子矩形对照 ===\n";
+    int failures = 0, cases = 0;
+    const size_t shapes[][2] = {{1, 1}, {5, 70}, {40, 130}, {300, 200}, {700, 129}};
+    for (const auto& shape : shapes) {
+        for (double density : {0.3, 0.8, 0.97, 1.0}) {
+            const size_t rows = shape[0], cols = shape[1];
+            BitMatrix matrix = BitMatrix::random(rows, cols, density, rows * cols);
+
+            // runs[r][c]：第 r 行从第 c 列起向右连续 1 的个数
+            std::vector<std::vector<int>> runs(rows, std::vector<int>(cols + 1, 0));
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t c = cols; c-- > 0;) runs[r][c] = matrix.get(r, c) ? runs[r][c + 1] + 1 : 0;
+            }
+            long long expected = 0;
+            for (size_t top = 0; top < rows; ++top) {
+                for (size_t c = 0; c < cols; ++c) {
+                    int width = runs[top][c];
+                    for (size_t r = top; r < rows && width > 0; ++r) {
+                        width = std::min(width, runs[r][c]);
+                        expected = std::max(expected, static_cast<long long>(width) * static_cast<long long>(r - top + 1));
+                    }
+                }
+            }
+
+            for (unsigned threads : {1u, 2u, 3u, 8u}) {
+                MatrixRectangle rect = MaximalRectangle::solve(matrix, threads);
+                bool allOnes = rect.bottom <= rows && rect.right <= cols &&
+                    static_cast<long long>(rect.bottom - rect.top) * static_cast<long long>(rect.right - rect.left) == rect.area;
+                for (size_t r = rect.top; allOnes && r < rect.bottom; ++r) {
+                    allOnes = runs[r][rect.left] >= static_cast<int>(rect.right - rect.left);
+                }
+                ++cases;
+                if (rect.area != expected || !allOnes) {
+                    ++failures;
+                    std::cout << "不一致: " << rows << "x" << cols << " 密度=" << density << " 线程=" << threads
+                              << " 结果=" << rect.area << " 穷举=" << expected << "\n";
+                }
+            }
+        }
+    }
+    std::cout << cases << " 组对照, " << failures << " 组不一致\n";
+}
+
+long long peakResidentKB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return -1;
+#endif
+}
+
+// 流式求解基准：分块写出 gigabytes 大小的 int32 高度文件(高度 0..10000)，
+// 再分别用分块读取和内存映射两种方式求解，报告吞吐量、栈深和进程峰值常驻内存
+void runStreamingBenchmark(double gigabytes, const std::string& path) {
+    std::cout << "\n=== 流式求解: " << gigabytes << " GB ===\n";
+    const size_t chunk = size_t(1) << 20;
+    const size_t chunks = static_cast<size_t>(gigabytes * (1ULL << 30) / (chunk * sizeof(int)));
+    const double bytes = static_cast<double>(chunks) * chunk * sizeof(int);
+
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) throw std::runtime_error("无法创建文件: " + path);
+        std::vector<int> buffer(chunk);
+        for (size_t c = 0; c < chunks; ++c) {
+            Xoshiro256 rng(DataGenerator::DEFAULT_SEED, c);
+            for (auto& h : buffer) h = static_cast<int>(rng.uniformInt(0, 10000));
+            out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(int));
+        }
+    }
+    std::cout << "生成文件: " << seconds(start) << " s, 峰值内存 " << peakResidentKB() / 1024 << " MB\n";
+
+    StreamingHistogramSolver fileSolver, mappedSolver;
+    start = std::chrono::steady_clock::now();
+    HistogramRectangle byFile = StreamingHistogramSolver::solveFile(path, &fileSolver);
+    double fileTime = seconds(start);
+    std::cout << "分块读取: " << fileTime << " s, " << bytes / fileTime / (1 << 30) << " GB/s, 最大栈深 "
+              << fileSolver.maxStackDepth() << ", 峰值内存 " << peakResidentKB() / 1024 << " MB\n";
+
+    start = std::chrono::steady_clock::now();
+    HistogramRectangle byMap = StreamingHistogramSolver::solveMapped(path, &mappedSolver);
+    double mapTime = seconds(start);
+    std::cout << "内存映射: " << mapTime << " s, " << bytes / mapTime / (1 << 30) << " GB/s, 最大栈深 "
+              << mappedSolver.maxStackDepth() << ", 峰值内存 " << peakResidentKB() / 1024 << " MB\n";
+
+    std::cout << "最大矩形: 面积 " << byFile.area << ", [" << byFile.start << ", " << byFile.end << "), 高 "
+              << byFile.height << (byFile.area == byMap.area && byFile.start == byMap.start ? "" : "  [两种读取结果不一致]")
+              << "\n";
+    std::remove(path.c_str());
+}
+
+// 强扩展性基准：n 个高度(0..10000)，线程数 1, 2, 4, ... 直到 maxThreads，
+// 每种线程数的结果都与串行流式求解(同为 64 位面积，且不复制输入)对照
+void runParallelBenchmark(size_t n, unsigned maxThreads) {
+    std::cout << "\n=== 并行求解: " << n << " 个高度 ===\n";
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> heights = DataGenerator::uniformInts(n, 0, 10000);
+    std::cout << "生成数据: " << seconds(start) << " s\n";
+
+    start = std::chrono::steady_clock::now();
+    StreamingHistogramSolver serial;
+    serial.push(heights.data(), heights.size());
+    HistogramRectangle expected = serial.finish();
+    double serialTime = seconds(start);
+    std::cout << "串行: " << serialTime << " s, 面积 " << expected.area << "\n";
+
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        start = std::chrono::steady_clock::now();
+        HistogramRectangle rect = ParallelHistogramSolver::solve(heights, threads);
+        double elapsed = seconds(start);
+        std::cout << "线程 " << threads << ": " << elapsed << " s, 加速比 " << serialTime / elapsed
+                  << (rect.area == expected.area ? "" : "  [与串行结果不一致]") << "\n";
+        if (threads >= maxThreads) break;
+    }
+}
+
+// 全 1 最大子矩形基准：size × size 的位压缩矩阵，分别为随机、稠密随机、
+// 随机背景中嵌入一个大的全 1 块、上三角阶梯四种；单线程与 threads 个线程的结果互相对照
+void runMatrixBenchmark(size_t size, unsigned threads) {
+    std::cout << "\n=== 全 1 最大子矩形: " << size << " x " << size << " ===\n";
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    const char* names[] = {"随机(0.5)", "稠密随机(0.99)", "嵌入全 1 块", "上三角阶梯"};
+    for (int kind = 0; kind < 4; ++kind) {
+        auto start = std::chrono::steady_clock::now();
+        BitMatrix matrix(0, 0);
+        if (kind == 0 || kind == 2) matrix = BitMatrix::random(size, size, 0.5);
+        else if (kind == 1) matrix = BitMatrix::random(size, size, 0.99);
+        else matrix = BitMatrix(size, size);
+        if (kind == 2) {
+            for (size_t r = size / 5; r < size * 4 / 5; ++r) matrix.fill(r, size / 10, size * 7 / 10);
+        } else if (kind == 3) {
+            for (size_t r = 0; r < size; ++r) matrix.fill(r, r, size);
+        }
+        std::cout << names[kind] << ": 生成 " << seconds(start) << " s\n";
+
+        const double cells = static_cast<double>(size) * static_cast<double>(size);
+        MatrixRectangle serial;
+        for (unsigned t : {1u, threads}) {
+            start = std::chrono::steady_clock::now();
+            MatrixRectangle rect = MaximalRectangle::solve(matrix, t);
+            double elapsed = seconds(start);
+            if (t == 1) serial = rect;
+            std::cout << "  线程 " << t << ": " << elapsed << " s, " << cells / elapsed / 1e9 << " G 格/s, 面积 "
+                      << rect.area << " 行 [" << rect.top << ", " << rect.bottom << ") 列 [" << rect.left << ", "
+                      << rect.right << ")" << (rect.area == serial.area ? "" : "  [与单线程结果不一致]") << "\n";
+            if (threads == 1) break;
+        }
+    }
+}
+
+// 子区间查询吞吐量：n 个随机高度上的短(≤100)、中(≤1e4)、任意长度三组查询，
+// 与每个查询都在子数组上重跑单调栈(只测前 1000 个，任意长度组只测前 100 个)比较
+void runRangeQueryBenchmark(size_t n, size_t queries) {
+    std::cout << "\n=== 子区间最大矩形查询: " << n << " 个高度, 每组 " << queries << " 个查询 ===\n";
+    auto heights = DataGenerator::uniformInts(n, 0, 10000);
+
+    auto start = std::chrono::steady_clock::now();
+    RangeRectangleQuery engine(heights);
+    std::chrono::duration<double> build = std::chrono::steady_clock::now() - start;
+    std::cout << "预处理: " << build.count() << " s, 占用 " << engine.memoryBytes() / (1 << 20) << " MB\n";
+
+    Benchmark bench;
+    HistogramKernel kernel;
+    const char* names[] = {"short", "medium", "any"};
+    const size_t spans[] = {100, 10000, n};
+    bool consistent = true;
+    for (int g = 0; g < 3; ++g) {
+        Xoshiro256 rng(DataGenerator::DEFAULT_SEED, g);
+        std::vector<std::pair<size_t, size_t>> ranges(queries);
+        for (auto& range : ranges) {
+            range.first = rng.uniformInt(0, n - 1);
+            range.second = rng.uniformInt(range.first, std::min(n - 1, range.first + spans[g] - 1));
+        }
+        const size_t sample = std::min<size_t>(queries, g == 2 ? 100 : 1000);
+        std::vector<long long> serial(queries), batch, stack(sample);
+
+        const std::string group = names[g];
+        double q1 = bench.run("query/" + group, [&] {
+            for (size_t q = 0; q < queries; ++q) serial[q] = engine.query(ranges[q].first, ranges[q].second);
+        }).median;
+        double qb = bench.run("batch/" + group, [&] { batch = engine.queryBatch(ranges); }).median;
+        double qs = bench.run("rescan x" + std::to_string(sample) + "/" + group, [&] {
+            for (size_t q = 0; q < sample; ++q) {
+                stack[q] = kernel.solve(heights.data() + ranges[q].first, ranges[q].second - ranges[q].first + 1);
+            }
+        }).median;
+        for (size_t q = 0; q < sample; ++q) consistent = consistent && stack[q] == serial[q];
+        consistent = consistent && batch == serial;
+        std::cout << group << ": 查询 " << queries / q1 << " 次/s, 批量 " << queries / qb << " 次/s, 重跑单调栈 "
+                  << sample / qs << " 次/s\n";
+    }
+    bench.printTable(std::cout);
+    std::cout << (consistent ? "查询结果与单调栈一致\n" : "[查询结果与单调栈不一致]\n");
+}
+
+int main(int argc, char* argv[]) {
+    // --range-bench [高度个数] [每组查询数]
+    if (argc > 1 && std::string(argv[1]) == "--range-bench") {
+        size_t n = argc > 2 ? static_cast<size_t>(std::stod(argv[2])) : 10000000;
+        size_t queries = argc > 3 ? static_cast<size_t>(std::stod(argv[3])) : 1000000;
+        runRangeQueryBenchmark(std::max<size_t>(n, 1), std::max<size_t>(queries, 1));
+        return 0;
+    }
+
+    // --matrix-bench [边长] [线程数]
+    if (argc > 1 && std::string(argv[1]) == "--matrix-bench") {
+        size_t size = argc > 2 ? static_cast<size_t>(std::stod(argv[2])) : 50000;
+        unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : hardwareThreads();
+        runMatrixBenchmark(size, std::max(1u, threads));
+        return 0;
+    }
+
+    // --parallel-bench [高度个数] [最大线程数]
+    if (argc > 1 && std::string(argv[1]) == "--parallel-bench") {
+        size_t n = argc > 2 ? static_cast<size_t>(std::stod(argv[2])) : 1000000000;
+        unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : hardwareThreads();
+        runParallelBenchmark(n, std::max(1u, maxThreads));
+        return 0;
+    }
+
+    // --stream-bench [GB] [临时文件路径]
+    if (argc > 1 && std::string(argv[1]) == "--stream-bench") {
+        double gigabytes = argc > 2 ? std::stod(argv[2]) : 2.0;
+        std::string path = argc > 3 ? argv[3] : "histogram_stream.bin";
+        runStreamingBenchmark(gigabytes, path);
+        return 0;
+    }
+
     runBasicTests();
     runRandomTests();
+    runParallelTests();
+    runMatrixTests();
+    runRangeQueryTests();
     return 0;
 }
\ No newline at end of file
@@ -6,6 +6,18 @@
 #include <vector>
 #include <algorithm>
 #include <fstream>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "../common/data_generator.h"
+#include "../common/parallel_for.h"
+#include "../common/benchmark.h"
 
 using namespace std;
 
@@ -42,6 +54,9 @@ public:
     }
     
     int size() { return _sz; }
+
+    // 底层字节，第 k 位是第 k / 8 个字节的第 7 - k % 8 位(高位在前)
+    const unsigned char* bytes() const { return M; }
     
     void set(int k) {
         expand(k);
@@ -303,6 +318,13 @@ public:
     const unordered_map<char, string>& getCodeMap() const {
         return _codeMap;
     }
+
+    // 各字符(按 unsigned char 下标)的码长，未出现的字符为 0
+    array<int, 256> codeLengths() const {
+        array<int, 256> lengths{};
+        for (const auto& pair : _codeMap) lengths[(unsigned char)pair.first] = (int)pair.second.length();
+        return lengths;
+    }
     
     void printCodes() {
         cout << "Huffman Codes:" << endl;
@@ -318,6 +340,248 @@ public:
     }
 };
 
+// 位流写入：码先拼进 64 位缓冲(高位在前)，攒满 64 位才整字写出 8 个字节，
+// 输出的位序与 Bitmap 相同，每位只占 1/8 字节
+class BitWriter {
+private:
+    vector<unsigned char> _bytes;
+    uint64_t _buffer;
+    int _used;                     // 缓冲中已用的位数，始终小于 64
+
+    void emit() {
+        size_t at = _bytes.size();
+        _bytes.resize(at + 8);
+        for (int k = 0; k < 8; ++k) _bytes[at + k] = (unsigned char)(_buffer >> (56 - 8 * k));
+        _buffer = 0;
+        _used = 0;
+    }
+
+public:
+    BitWriter() : _buffer(0), _used(0) {}
+
+    void reserve(size_t bytes) { _bytes.reserve(bytes); }
+
+    // 写出 code 的低 length 位(length 不超过 32)
+    void write(uint32_t code, int length) {
+        if (_used + length >= 64) {
+            int first = 64 - _used;
+            _buffer |= (uint64_t)code >> (length - first);
+            emit();
+            length -= first;
+            code &= (uint32_t)(((uint64_t)1 << length) - 1);
+        }
+        if (length) {
+            _buffer |= (uint64_t)code << (64 - _used - length);
+            _used += length;
+        }
+    }
+
+    size_t bitCount() const { return _bytes.size() * 8 + _used; }
+
+    // 写出缓冲中剩余的位，末字节低位补 0；之后可继续写入新的位流
+    const vector<unsigned char>& finish() {
+        for (int k = 0; k < (_used + 7) / 8; ++k) _bytes.push_back((unsigned char)(_buffer >> (56 - 8 * k)));
+        _buffer = 0;
+        _used = 0;
+        return _bytes;
+    }
+
+    const vector<unsigned char>& bytes() const { return _bytes; }
+
+    void clear() {
+        _bytes.clear();
+        _buffer = 0;
+        _used = 0;
+    }
+};
+
+// 规范 Huffman 编码：只由各字符的码长决定。码长相同的字符按字符值递增依次取连续的码，
+// 每个码长的第一个码是上一码长最后一个码加一再左移一位。
+// 码长与 HuffTree 相同，因此压缩率不变，但码本身可由码长表重建，不必保存整棵树。
+// 解码读取高位在前的位流：一次查表取 TABLE_BITS 位，表项中预存这些位里能完整解出的
+// 全部字符(至多 MAX_SYMBOLS 个)；码长超过 TABLE_BITS 的字符按码长逐级比较
+class CanonicalHuffman {
+public:
+    static const int MAX_CODE_LENGTH = 32;
+    static const int TABLE_BITS = 11;
+    static const int MAX_SYMBOLS = 6;
+
+private:
+    struct Entry {
+        unsigned char symbols[MAX_SYMBOLS];
+        unsigned char count;       // 0 表示第一个字符的码长超过 TABLE_BITS
+        unsigned char bits;        // 这些字符共占的位数
+    };
+
+    // 编码表：每个字符的 (码, 码长) 放在一起，编码时一次读取
+    struct Code {
+        uint32_t bits;
+        uint32_t length;
+    };
+
+    array<Code, 256> _codes{};
+    array<uint32_t, MAX_CODE_LENGTH + 1> _firstCode{};
+    array<uint32_t, MAX_CODE_LENGTH + 1> _count{};
+    array<uint32_t, MAX_CODE_LENGTH + 1> _offset{};    // 该码长的第一个字符在 _sorted 中的位置
+    vector<unsigned char> _sorted;                     // 按 (码长, 字符) 排序的字符
+    vector<Entry> _table;
+
+    // 从 pos 位起的 64 位窗口(至少 57 位有效)；末尾不足 8 字节时逐字节拼接，越界部分补 0
+    static uint64_t peek(const unsigned char* data, size_t bytes, size_t pos) {
+        size_t at = pos >> 3;
+        uint64_t window = 0;
+        if (at + 8 <= bytes) {
+#if defined(__GNUC__)
+            memcpy(&window, data + at, 8);
+            window = __builtin_bswap64(window);
+#else
+            for (int k = 0; k < 8; ++k) window = (window << 8) | data[at + k];
+#endif
+        } else {
+            for (int k = 0; k < 8; ++k) window = (window << 8) | (at + k < bytes ? data[at + k] : 0);
+        }
+        return window << (pos & 7);
+    }
+
+    // 码长超过 TABLE_BITS 的字符：按码长递增比较，返回码长，字符写入 symbol
+    int decodeLong(uint64_t window, unsigned char& symbol) const {
+        for (int len = TABLE_BITS + 1; len <= MAX_CODE_LENGTH; ++len) {
+            uint32_t code = (uint32_t)(window >> (64 - len));
+            if (code - _firstCode[len] < _count[len]) {
+                symbol = _sorted[_offset[len] + code - _firstCode[len]];
+                return len;
+            }
+        }
+        throw runtime_error("位流中出现无效编码");
+    }
+
+public:
+    CanonicalHuffman() {}
+
+    // lengths[c] 为字符 c 的码长，0 表示不出现
+    explicit CanonicalHuffman(const array<int, 256>& lengths) {
+        for (int c = 0; c < 256; ++c) {
+            if (lengths[c] < 0 || lengths[c] > MAX_CODE_LENGTH) throw invalid_argument("码长超出范围");
+            _codes[c].length = (uint32_t)lengths[c];
+            if (lengths[c]) _count[lengths[c]]++;
+        }
+        // Kraft 不等式：码长必须能构成前缀码
+        uint64_t kraft = 0;
+        for (int len = 1; len <= MAX_CODE_LENGTH; ++len) kraft += (uint64_t)_count[len] << (MAX_CODE_LENGTH - len);
+        if (kraft > ((uint64_t)1 << MAX_CODE_LENGTH)) throw invalid_argument("码长不构成前缀码");
+
+        uint32_t code = 0, offset = 0;
+        for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+            code = (code + (len > 1 ? _count[len - 1] : 0)) << (len > 1 ? 1 : 0);
+            _firstCode[len] = code;
+            _offset[len] = offset;
+            offset += _count[len];
+        }
+        _sorted.resize(offset);
+        array<uint32_t, MAX_CODE_LENGTH + 1> next = _offset;
+        for (int c = 0; c < 256; ++c) {
+            int len = _codes[c].length;
+            if (!len) continue;
+            _codes[c].bits = _firstCode[len] + (next[len] - _offset[len]);
+            _sorted[next[len]++] = (unsigned char)c;
+        }
+
+        // 单字符表：TABLE_BITS 位前缀 -> (字符, 码长)，再据此拼出多字符表
+        const uint32_t size = 1u << TABLE_BITS;
+        vector<unsigned char> single(size, 0), singleLength(size, 0);
+        for (int c = 0; c < 256; ++c) {
+            int len = _codes[c].length;
+            if (!len || len > TABLE_BITS) continue;
+            uint32_t first = _codes[c].bits << (TABLE_BITS - len);
+            for (uint32_t k = 0; k < (1u << (TABLE_BITS - len)); ++k) {
+                single[first + k] = (unsigned char)c;
+                singleLength[first + k] = (unsigned char)len;
+            }
+        }
+        _table.resize(size);
+        for (uint32_t prefix = 0; prefix < size; ++prefix) {
+            Entry& e = _table[prefix];
+            e.count = e.bits = 0;
+            while (e.count < MAX_SYMBOLS) {
+                uint32_t rest = (prefix << e.bits) & (size - 1);
+                int len = singleLength[rest];
+                if (!len || e.bits + len > TABLE_BITS) break;
+                e.symbols[e.count++] = single[rest];
+                e.bits += len;
+            }
+        }
+    }
+
+    int length(unsigned char c) const { return _codes[c].length; }
+    uint32_t code(unsigned char c) const { return _codes[c].bits; }
+
+    // 把 data[0, n) 编码写入 out；码表中没有的字符(码长为 0)不写出任何位
+    void encode(const unsigned char* data, size_t n, BitWriter& out) const {
+        for (size_t i = 0; i < n; ++i) {
+            const Code& c = _codes[data[i]];
+            out.write(c.bits, c.length);
+        }
+    }
+
+    void encode(const string& text, BitWriter& out) const {
+        encode((const unsigned char*)text.data(), text.size(), out);
+    }
+
+    // 从 bytes 字节的位流中解出 count 个字符写入 out
+    void decode(const unsigned char* data, size_t bytes, size_t count, unsigned char* out) const {
+        size_t pos = 0, produced = 0;
+        // 一个窗口至少有 57 位，足够连续查 LOOKUPS 次表
+        const int LOOKUPS = 57 / TABLE_BITS;
+        while (produced + LOOKUPS * MAX_SYMBOLS <= count) {
+            uint64_t window = peek(data, bytes, pos);
+            int used = 0;
+            for (int k = 0; k < LOOKUPS; ++k) {
+                const Entry& e = _table[(window << used) >> (64 - TABLE_BITS)];
+                if (!e.count) break;
+                memcpy(out + produced, e.symbols, MAX_SYMBOLS);
+                produced += e.count;
+                used += e.bits;
+            }
+            pos += used;
+            // 几次查表可能恰好写满 count 个字符，此时不能再解长码
+            if (produced < count && _table[(window << used) >> (64 - TABLE_BITS)].count == 0) {
+                pos += decodeLong(peek(data, bytes, pos), out[produced++]);
+            }
+        }
+        // 末尾几个字符逐个解码，避免写出 count 之外的字符
+        while (produced < count) {
+            uint64_t window = peek(data, bytes, pos);
+            const Entry& e = _table[window >> (64 - TABLE_BITS)];
+            if (e.count) {
+                out[produced] = e.symbols[0];
+                pos += _codes[out[produced++]].length;
+            } else {
+                pos += decodeLong(window, out[produced++]);
+            }
+        }
+    }
+
+    string decode(const unsigned char* data, size_t bytes, size_t count) const {
+        string result(count, '\0');
+        decode(data, bytes, count, (unsigned char*)&result[0]);
+        return result;
+    }
+};
+
+// 用规范码把文本逐位写入位图，返回总位数；码表中没有的字符跳过
+int packWithBitmap(const CanonicalHuffman& canonical, const string& text, Bitmap& bitmap) {
+    int pos = 0;
+    for (char ch : text) {
+        unsigned char c = (unsigned char)ch;
+        int len = canonical.length(c);
+        for (int k = len - 1; k >= 0; --k, ++pos) {
+            if ((canonical.code(c) >> k) & 1) bitmap.set(pos);
+        }
+    }
+    if (pos > 0) bitmap.expand(pos - 1);      // 末尾全为 0 的位也要占有空间
+    return pos;
+}
+
 // 文本处理函数
 unordered_map<char, int> calculateFrequency(const string& text) {
     unordered_map<char, int> freqMap;
@@ -332,10 +596,288 @@ unordered_map<char, int> calculateFrequency(const string& text) {
     return freqMap;
 }
 
-// 主函数
-int main() {
-    // 《I Have a Dream》演讲片段
-    string speech = 
+// 全部 256 个字节值的出现次数，累加到 counts(可分块多次调用)。
+// 四组计数轮流使用，相邻的相同字节不会反复写同一个计数器
+void calculateFrequency(const unsigned char* data, size_t n, array<uint64_t, 256>& counts) {
+    vector<uint64_t> partial(4 * 256, 0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        partial[data[i]]++;
+        partial[256 + data[i + 1]]++;
+        partial[512 + data[i + 2]]++;
+        partial[768 + data[i + 3]]++;
+    }
+    for (; i < n; ++i) partial[data[i]]++;
+    for (int c = 0; c < 256; ++c) counts[c] += partial[c] + partial[256 + c] + partial[512 + c] + partial[768 + c];
+}
+
+// 由字节计数构造 HuffTree 并取出码长。HuffTree 的权重是 int，计数先按比例缩小
+// (出现过的字节至少保留 1)；码长超过 CanonicalHuffman::MAX_CODE_LENGTH 时把权重减半重建，
+// 分布逐步变平，码长随之缩短
+array<int, 256> huffmanCodeLengths(const array<uint64_t, 256>& counts) {
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+    const uint64_t limit = (uint64_t)1 << 30;
+    uint64_t scale = total > limit ? (total + limit - 1) / limit : 1;
+    array<int, 256> weights{};
+    for (int c = 0; c < 256; ++c) {
+        if (counts[c]) weights[c] = (int)max<uint64_t>(1, counts[c] / scale);
+    }
+
+    while (true) {
+        unordered_map<char, int> freqMap;
+        for (int c = 0; c < 256; ++c) {
+            if (weights[c]) freqMap[(char)c] = weights[c];
+        }
+        array<int, 256> lengths{};
+        if (freqMap.empty()) return lengths;
+        HuffTree tree;
+        tree.build(freqMap);
+        lengths = tree.codeLengths();
+        if (*max_element(lengths.begin(), lengths.end()) <= CanonicalHuffman::MAX_CODE_LENGTH) return lengths;
+        for (int& w : weights) {
+            if (w) w = max(1, w / 2);
+        }
+    }
+}
+
+struct HuffFileStats {
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+};
+
+// 文件压缩：两遍扫描，第一遍统计全部 256 个字节值的频率，得到整个文件共用的码表；
+// 第二遍把输入切成互不依赖的块，每次读入一批块，由多个线程并行编码后按次序写出。
+// 解压同样按批读入、并行解码，内存只与块大小和线程数有关。文件格式(整数均为小端)：
+//   "HUF1" | 原始字节数 u64 | 块大小 u32 | 256 个字节值的码长各 1 字节 | 各块 | 索引
+//   块：压缩后字节数 u32 | 位流(高位在前，末字节补 0)
+//   索引：各块在文件中的偏移 u64 × 块数 | 索引的偏移 u64 | "HIDX"
+// 每块单独从字节边界开始，除最后一块外原始长度都等于块大小；
+// 借助索引可以只解压任意一块(见 HuffReader)。
+// 格式中没有校验和：文件头、块长度与索引不一致时会报错，但块内位流被改动时
+// 照常解出同样长度的错误内容
+class HuffFile {
+public:
+    static const size_t DEFAULT_BLOCK = 1 << 20;
+    static const size_t HEADER_BYTES = 4 + 8 + 4 + 256;
+    // 每批每个线程处理的块数
+    static const size_t BLOCKS_PER_THREAD = 4;
+
+    static HuffFileStats compress(const string& inPath, const string& outPath, size_t blockSize = DEFAULT_BLOCK,
+                                  unsigned threads = hardwareThreads()) {
+        if (blockSize == 0 || blockSize > (1u << 30)) throw invalid_argument("块大小超出范围");
+        threads = max(1u, threads);
+        ifstream in(inPath, ios::binary);
+        if (!in) throw runtime_error("无法打开文件: " + inPath);
+        const size_t batchBlocks = threads * BLOCKS_PER_THREAD;
+        vector<unsigned char> buffer(batchBlocks * blockSize);
+
+        // 第一遍：各线程统计批内的一段，最后合并
+        array<uint64_t, 256> counts{};
+        vector<array<uint64_t, 256>> partial(threads);
+        uint64_t size = 0;
+        while (in) {
+            in.read((char*)buffer.data(), buffer.size());
+            size_t n = (size_t)in.gcount();
+            for (auto& p : partial) p.fill(0);
+            parallelChunks(n, threads, [&](unsigned t, size_t begin, size_t end) {
+                calculateFrequency(buffer.data() + begin, end - begin, partial[t]);
+            });
+            for (const auto& p : partial) {
+                for (int c = 0; c < 256; ++c) counts[c] += p[c];
+            }
+            size += n;
+        }
+        array<int, 256> lengths = huffmanCodeLengths(counts);
+        CanonicalHuffman canonical(lengths);
+
+        ofstream out(outPath, ios::binary);
+        if (!out) throw runtime_error("无法创建文件: " + outPath);
+        out.write("HUF1", 4);
+        writeInt(out, size, 8);
+        writeInt(out, blockSize, 4);
+        for (int len : lengths) out.put((char)len);
+
+        in.clear();
+        in.seekg(0);
+        vector<BitWriter> writers(batchBlocks);
+        for (auto& writer : writers) writer.reserve(blockSize + 8);
+        vector<uint64_t> offsets;
+        uint64_t position = HEADER_BYTES;
+        for (uint64_t done = 0; done < size;) {
+            size_t bytes = (size_t)min<uint64_t>(buffer.size(), size - done);
+            in.read((char*)buffer.data(), bytes);
+            if ((size_t)in.gcount() != bytes) throw runtime_error("读取文件时长度发生变化: " + inPath);
+            size_t blocks = (bytes + blockSize - 1) / blockSize;
+            parallelChunks(blocks, (unsigned)min<size_t>(threads, blocks), [&](unsigned, size_t first, size_t last) {
+                for (size_t b = first; b < last; ++b) {
+                    writers[b].clear();
+                    canonical.encode(buffer.data() + b * blockSize, min(blockSize, bytes - b * blockSize), writers[b]);
+                    writers[b].finish();
+                }
+            });
+            for (size_t b = 0; b < blocks; ++b) {
+                const vector<unsigned char>& packed = writers[b].bytes();
+                offsets.push_back(position);
+                writeInt(out, packed.size(), 4);
+                out.write((const char*)packed.data(), packed.size());
+                position += 4 + packed.size();
+            }
+            done += bytes;
+        }
+
+        for (uint64_t offset : offsets) writeInt(out, offset, 8);
+        writeInt(out, position, 8);
+        out.write("HIDX", 4);
+        if (!out) throw runtime_error("写入文件失败: " + outPath);
+
+        HuffFileStats stats;
+        stats.inputBytes = size;
+        stats.outputBytes = position + 8 * offsets.size() + 12;
+        return stats;
+    }
+
+    static HuffFileStats decompress(const string& inPath, const string& outPath, unsigned threads = hardwareThreads());
+
+    static void writeInt(ostream& out, uint64_t value, int bytes) {
+        for (int k = 0; k < bytes; ++k) out.put((char)(value >> (8 * k)));
+    }
+
+    static uint64_t readInt(istream& in, int bytes) {
+        uint64_t value = 0;
+        for (int k = 0; k < bytes; ++k) value |= (uint64_t)(unsigned char)in.get() << (8 * k);
+        return value;
+    }
+};
+
+// 压缩文件的随机访问：打开时读入文件头与块索引，之后可单独读取、解码任意一块。
+// 没有索引的文件(只写了各块)在打开时顺序跳过各块重建索引
+class HuffReader {
+private:
+    ifstream _in;
+    string _path;
+    uint64_t _size = 0;
+    size_t _blockSize = 0;
+    CanonicalHuffman _canonical;
+    vector<uint64_t> _offsets;
+    uint64_t _fileSize = 0;
+
+    void corrupt() const {
+        throw runtime_error("压缩文件已损坏: " + _path);
+    }
+
+public:
+    explicit HuffReader(const string& path) : _in(path, ios::binary), _path(path) {
+        if (!_in) throw runtime_error("无法打开文件: " + path);
+        char magic[4] = {0};
+        _in.read(magic, 4);
+        if (!_in || memcmp(magic, "HUF1", 4) != 0) throw runtime_error("不是 Huffman 压缩文件: " + path);
+        _size = HuffFile::readInt(_in, 8);
+        _blockSize = (size_t)HuffFile::readInt(_in, 4);
+        array<int, 256> lengths{};
+        for (int& len : lengths) len = (unsigned char)_in.get();
+        if (!_in || _blockSize == 0 || _blockSize > (1u << 30)) corrupt();
+        _canonical = CanonicalHuffman(lengths);
+
+        const size_t blocks = (size_t)((_size + _blockSize - 1) / _blockSize);
+        _in.seekg(0, ios::end);
+        const uint64_t fileSize = _fileSize = (uint64_t)_in.tellg();
+        bool indexed = false;
+        if (fileSize >= HuffFile::HEADER_BYTES + 12 + 8 * (uint64_t)blocks) {
+            _in.seekg(fileSize - 12);
+            uint64_t indexOffset = HuffFile::readInt(_in, 8);
+            _in.read(magic, 4);
+            indexed = _in && memcmp(magic, "HIDX", 4) == 0 && indexOffset + 8 * (uint64_t)blocks + 12 == fileSize;
+            if (indexed) {
+                _in.seekg(indexOffset);
+                _offsets.resize(blocks);
+                for (auto& offset : _offsets) offset = HuffFile::readInt(_in, 8);
+                if (!_in) corrupt();
+            }
+        }
+        if (!indexed) {
+            _in.clear();
+            _offsets.clear();
+            uint64_t position = HuffFile::HEADER_BYTES;
+            for (size_t b = 0; b < blocks; ++b) {
+                _offsets.push_back(position);
+                _in.seekg(position);
+                position += 4 + HuffFile::readInt(_in, 4);
+                if (!_in || position > fileSize) corrupt();
+            }
+        }
+    }
+
+    uint64_t size() const { return _size; }
+    uint64_t fileSize() const { return _fileSize; }
+    size_t blockSize() const { return _blockSize; }
+    size_t blockCount() const { return _offsets.size(); }
+
+    // 第 b 块的原始长度
+    size_t blockLength(size_t b) const {
+        return (size_t)min<uint64_t>(_blockSize, _size - (uint64_t)b * _blockSize);
+    }
+
+    // 读入第 b 块的压缩数据(不解码)
+    void readPacked(size_t b, vector<unsigned char>& packed) {
+        if (b >= _offsets.size()) throw out_of_range("块号越界");
+        _in.seekg(_offsets[b]);
+        size_t bytes = (size_t)HuffFile::readInt(_in, 4);
+        // 码长不超过 32 位，一块压缩后不会超过原始长度的 4 倍
+        if (!_in || bytes > 4 * _blockSize + 8) corrupt();
+        packed.resize(bytes);
+        _in.read((char*)packed.data(), bytes);
+        if ((size_t)_in.gcount() != bytes) throw runtime_error("压缩文件不完整: " + _path);
+    }
+
+    // 解码第 b 块的压缩数据，写入 out[0, blockLength(b))；只读，可在多个线程中同时调用
+    void decodeBlock(size_t b, const vector<unsigned char>& packed, unsigned char* out) const {
+        _canonical.decode(packed.data(), packed.size(), blockLength(b), out);
+    }
+
+    vector<unsigned char> readBlock(size_t b) {
+        vector<unsigned char> packed;
+        readPacked(b, packed);
+        vector<unsigned char> block(blockLength(b));
+        decodeBlock(b, packed, block.data());
+        return block;
+    }
+};
+
+// 按批顺序读入压缩块，批内各块并行解码，再按次序写出
+HuffFileStats HuffFile::decompress(const string& inPath, const string& outPath, unsigned threads) {
+    threads = max(1u, threads);
+    HuffReader reader(inPath);
+    ofstream out(outPath, ios::binary);
+    if (!out) throw runtime_error("无法创建文件: " + outPath);
+
+    const size_t batchBlocks = threads * BLOCKS_PER_THREAD;
+    vector<vector<unsigned char>> packed(batchBlocks);
+    vector<unsigned char> buffer(batchBlocks * reader.blockSize());
+    HuffFileStats stats;
+    stats.inputBytes = reader.fileSize();
+    for (size_t first = 0; first < reader.blockCount(); first += batchBlocks) {
+        size_t blocks = min(batchBlocks, reader.blockCount() - first);
+        size_t bytes = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            reader.readPacked(first + b, packed[b]);
+            bytes += reader.blockLength(first + b);
+        }
+        parallelChunks(blocks, (unsigned)min<size_t>(threads, blocks), [&](unsigned, size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                reader.decodeBlock(first + b, packed[b], buffer.data() + b * reader.blockSize());
+            }
+        });
+        out.write((const char*)buffer.data(), bytes);
+        stats.outputBytes += bytes;
+    }
+    if (!out) throw runtime_error("写入文件失败: " + outPath);
+    return stats;
+}
+
+// 《I Have a Dream》演讲片段
+string speechText() {
+    return
         "I have a dream that one day this nation will rise up and live out the true meaning of its creed. "
         "I have a dream that one day on the red hills of Georgia the sons of former slaves and the sons of "
         "former slave owners will be able to sit down together at the table of brotherhood. "
@@ -343,6 +885,492 @@ int main() {
         "injustice sweltering with the heat of oppression will be transformed into an oasis of freedom and justice. "
         "I have a dream that my four little children will one day live in a nation where they will not be "
         "judged by the color of their skin but by the content of their character. I have a dream today.";
+}
+
+// 只保留字母并转为小写，即 HuffTree 能编码的字符
+string lettersOnly(const string& text) {
+    string result;
+    for (char c : text) {
+        if (isalpha(c)) result += (char)tolower(c);
+    }
+    return result;
+}
+
+// 随机抽取演讲中的单词拼接成约 bytes 个字母的语料，同一 seed 结果相同
+string generateCorpus(size_t bytes, uint64_t seed = DataGenerator::DEFAULT_SEED) {
+    vector<string> words;
+    string word;
+    for (char c : speechText() + " ") {
+        if (isalpha(c)) {
+            word += (char)tolower(c);
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    Xoshiro256 rng(seed);
+    string corpus;
+    corpus.reserve(bytes + 32);
+    while (corpus.size() < bytes) corpus += words[rng.uniformInt(0, words.size() - 1)];
+    corpus.resize(bytes);
+    return corpus;
+}
+
+// 随机抽取演讲中的单词(保留大小写)并以空格、标点、换行分隔，生成约 bytes 字节的英文文本
+string generateText(size_t bytes, uint64_t seed = DataGenerator::DEFAULT_SEED, uint64_t stream = 0) {
+    static const vector<string> words = [] {
+        vector<string> list;
+        string word;
+        for (char c : speechText() + " ") {
+            if (isalpha(c)) {
+                word += c;
+            } else if (!word.empty()) {
+                list.push_back(word);
+                word.clear();
+            }
+        }
+        return list;
+    }();
+    static const char* separators[] = {" ", " ", " ", " ", " ", " ", ", ", ". ", ".\n", "; "};
+    Xoshiro256 rng(seed, stream);
+    string text;
+    text.reserve(bytes + 32);
+    while (text.size() < bytes) {
+        text += words[rng.uniformInt(0, words.size() - 1)];
+        text += separators[rng.uniformInt(0, 9)];
+    }
+    text.resize(bytes);
+    return text;
+}
+
+bool sameFile(const string& a, const string& b) {
+    ifstream x(a, ios::binary), y(b, ios::binary);
+    vector<char> bx(1 << 20), by(1 << 20);
+    while (x && y) {
+        x.read(bx.data(), bx.size());
+        y.read(by.data(), by.size());
+        if (x.gcount() != y.gcount() || memcmp(bx.data(), by.data(), (size_t)x.gcount()) != 0) return false;
+    }
+    return !x && !y;
+}
+
+// 文件压缩往返测试：空文件、单一字节、全部字节值、英文文本，各种块大小；
+// 另外检查权重呈斐波那契数列(树深超过 32)时码长被限制在 MAX_CODE_LENGTH 以内
+void runFileTests() {
+    cout << "\n=== File compression round trips ===" << endl;
+    const string input = "huff_test.tmp", packed = "huff_test.huf", output = "huff_test.out";
+    Xoshiro256 rng(DataGenerator::DEFAULT_SEED);
+    string bytes;
+    for (int i = 0; i < 100000; ++i) bytes += (char)rng.uniformInt(0, 255);
+    vector<pair<string, string>> cases = {
+        {"empty", ""}, {"single byte", string(5000, 'x')}, {"all bytes", bytes}, {"text", generateText(300000)}};
+    int passed = 0, total = 0;
+    for (const auto& test : cases) {
+        for (size_t blockSize : {(size_t)1000, (size_t)4096, HuffFile::DEFAULT_BLOCK}) {
+            for (unsigned threads : {1u, 3u}) {
+                ofstream(input, ios::binary).write(test.second.data(), test.second.size());
+                HuffFileStats stats = HuffFile::compress(input, packed, blockSize, threads);
+                HuffFile::decompress(packed, output, 4 - threads);
+                bool ok = sameFile(input, output);
+
+                // 随机访问：逐块读取并与原文对应的片段比较
+                HuffReader reader(packed);
+                for (size_t b = 0; ok && b < reader.blockCount(); b += 7) {
+                    vector<unsigned char> block = reader.readBlock(b);
+                    ok = memcmp(block.data(), test.second.data() + b * blockSize, block.size()) == 0;
+                }
+                total++;
+                passed += ok;
+                if ((blockSize == HuffFile::DEFAULT_BLOCK && threads == 1) || !ok) {
+                    cout << "File " << test.first << ": " << stats.inputBytes << " -> " << stats.outputBytes << " bytes"
+                         << (ok ? "" : "  [MISMATCH]") << endl;
+                }
+            }
+        }
+    }
+
+    // 去掉索引后仍能解压：HuffReader 顺序跳过各块重建索引
+    {
+        const string& text = cases.back().second;
+        ofstream(input, ios::binary).write(text.data(), text.size());
+        HuffFile::compress(input, packed, 4096, 2);
+        size_t blocks = (text.size() + 4095) / 4096;
+        ifstream whole(packed, ios::binary);
+        string data((istreambuf_iterator<char>(whole)), istreambuf_iterator<char>());
+        whole.close();
+        ofstream(packed, ios::binary).write(data.data(), data.size() - 8 * blocks - 12);
+        HuffFile::decompress(packed, output, 2);
+        bool ok = sameFile(input, output) && HuffReader(packed).blockCount() == blocks;
+        total++;
+        passed += ok;
+        cout << "File without index: " << (ok ? "ok" : "[MISMATCH]") << endl;
+    }
+
+    // 损坏的压缩文件：要么报错，要么写出的文件恰好与原文一样长，解码不能越界。
+    // 没有校验和，块内的改动检测不到，这里不检查内容
+    {
+        const string& text = cases.back().second;
+        ofstream(input, ios::binary).write(text.data(), text.size());
+        HuffFile::compress(input, packed, 4096, 2);
+        ifstream whole(packed, ios::binary);
+        string data((istreambuf_iterator<char>(whole)), istreambuf_iterator<char>());
+        whole.close();
+        Xoshiro256 noise(DataGenerator::DEFAULT_SEED);
+        for (size_t i = HuffFile::HEADER_BYTES + 4; i < HuffFile::HEADER_BYTES + 4 + 2000; ++i) {
+            data[i] = (char)noise.uniformInt(0, 255);
+        }
+        bool ok = true;
+        for (size_t keep : {data.size(), data.size() / 2}) {
+            ofstream(packed, ios::binary).write(data.data(), keep);
+            try {
+                HuffFile::decompress(packed, output, 2);
+                ifstream written(output, ios::binary | ios::ate);
+                ok = ok && (uint64_t)written.tellg() == text.size();
+            } catch (const runtime_error&) {
+            }
+        }
+        total++;
+        passed += ok;
+        cout << "Damaged file: " << (ok ? "error or original length" : "[WRONG LENGTH]") << endl;
+    }
+    remove(input.c_str());
+    remove(packed.c_str());
+    remove(output.c_str());
+
+    array<uint64_t, 256> counts{};
+    uint64_t a = 1, b = 1;
+    for (int c = 0; c < 40; ++c) {                 // 不限制时最长的码为 39 位
+        counts[c] = a;
+        uint64_t next = a + b;
+        a = b;
+        b = next;
+    }
+    array<int, 256> lengths = huffmanCodeLengths(counts);
+    int longest = *max_element(lengths.begin(), lengths.end());
+    bool limited = longest <= CanonicalHuffman::MAX_CODE_LENGTH;
+    try {
+        CanonicalHuffman canonical(lengths);
+    } catch (const exception&) {
+        limited = false;
+    }
+    total++;
+    passed += limited;
+    cout << "Fibonacci weights: longest code " << longest << " bits" << (limited ? "" : "  [NOT LIMITED]") << endl;
+    cout << passed << "/" << total << " file tests passed" << endl;
+}
+
+long long peakResidentMB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+#else
+    return -1;
+#endif
+}
+
+// 文件压缩基准：分块生成约 gigabytes GB 的英文文本，压缩、解压并逐字节比较，
+// 报告压缩率、两个方向的吞吐量与进程峰值内存
+void runFileBenchmark(double gigabytes, const string& path) {
+    cout << "\n=== File compression benchmark: " << gigabytes << " GB ===" << endl;
+    const size_t chunk = 16 << 20;
+    const size_t chunks = max<size_t>(1, (size_t)(gigabytes * (1ULL << 30) / chunk));
+    {
+        ofstream out(path, ios::binary);
+        if (!out) throw runtime_error("无法创建文件: " + path);
+        for (size_t c = 0; c < chunks; ++c) {
+            string text = generateText(chunk, DataGenerator::DEFAULT_SEED, c);
+            out.write(text.data(), text.size());
+        }
+    }
+    const string packed = path + ".huf", output = path + ".out";
+    auto seconds = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = chrono::steady_clock::now();
+    HuffFileStats stats = HuffFile::compress(path, packed);
+    double compressTime = seconds(start);
+    start = chrono::steady_clock::now();
+    HuffFile::decompress(packed, output);
+    double decompressTime = seconds(start);
+
+    double mb = (double)stats.inputBytes / (1 << 20);
+    cout << "Input: " << stats.inputBytes << " bytes, compressed: " << stats.outputBytes << " bytes ("
+         << 100.0 * stats.outputBytes / stats.inputBytes << "%)" << endl;
+    cout << "Compress:   " << compressTime << " s, " << mb / compressTime << " MB/s" << endl;
+    cout << "Decompress: " << decompressTime << " s, " << mb / decompressTime << " MB/s" << endl;
+    cout << "Peak memory: " << peakResidentMB() << " MB" << (sameFile(path, output) ? "" : "  [MISMATCH]") << endl;
+    remove(path.c_str());
+    remove(packed.c_str());
+    remove(output.c_str());
+}
+
+// 并行压缩基准：生成约 gigabytes GB 的英文文本，线程数 1, 2, 4, ... 直到 maxThreads 分别压缩、解压，
+// 并以单线程 HuffTree 路径('0'/'1' 字符串编码与逐位解码，取前 64 MB 测量)作为基线；
+// 最后随机读取若干块，检查随机访问的结果与原文一致
+void runParallelFileBenchmark(double gigabytes, unsigned maxThreads, const string& path) {
+    cout << "\n=== Parallel file compression: " << gigabytes << " GB, up to " << maxThreads << " threads ===" << endl;
+    const size_t chunk = 16 << 20;
+    const size_t chunks = max<size_t>(1, (size_t)(gigabytes * (1ULL << 30) / chunk));
+    {
+        ofstream out(path, ios::binary);
+        if (!out) throw runtime_error("无法创建文件: " + path);
+        for (size_t c = 0; c < chunks; ++c) {
+            string text = generateText(chunk, DataGenerator::DEFAULT_SEED, c);
+            out.write(text.data(), text.size());
+        }
+    }
+    auto seconds = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    {
+        string sample = generateText(min<size_t>(64 << 20, chunks * chunk), DataGenerator::DEFAULT_SEED, 0);
+        unordered_map<char, int> freqMap;
+        for (char c : sample) freqMap[c]++;
+        HuffTree tree;
+        tree.build(freqMap);
+        double mb = (double)sample.size() / (1 << 20);
+        auto start = chrono::steady_clock::now();
+        string bits = tree.encode(sample);
+        double encodeTime = seconds(start);
+        start = chrono::steady_clock::now();
+        string decoded = tree.decode(bits);
+        double decodeTime = seconds(start);
+        cout << "HuffTree baseline: encode " << mb / encodeTime << " MB/s, decode " << mb / decodeTime << " MB/s" << endl;
+    }
+
+    const string packed = path + ".huf", output = path + ".out";
+    const double mb = (double)chunks * chunk / (1 << 20);
+    double baseCompress = 0.0, baseDecompress = 0.0;
+    for (unsigned threads = 1;; threads = min(threads * 2, maxThreads)) {
+        auto start = chrono::steady_clock::now();
+        HuffFileStats stats = HuffFile::compress(path, packed, HuffFile::DEFAULT_BLOCK, threads);
+        double compressTime = seconds(start);
+        start = chrono::steady_clock::now();
+        HuffFile::decompress(packed, output, threads);
+        double decompressTime = seconds(start);
+        if (threads == 1) {
+            baseCompress = compressTime;
+            baseDecompress = decompressTime;
+        }
+        cout << "Threads " << threads << ": compress " << mb / compressTime << " MB/s (" << baseCompress / compressTime
+             << "x), decompress " << mb / decompressTime << " MB/s (" << baseDecompress / decompressTime << "x), ratio "
+             << 100.0 * stats.outputBytes / stats.inputBytes << "%" << (sameFile(path, output) ? "" : "  [MISMATCH]")
+             << endl;
+        if (threads >= maxThreads) break;
+    }
+
+    HuffReader reader(packed);
+    ifstream original(path, ios::binary);
+    Xoshiro256 rng(DataGenerator::DEFAULT_SEED);
+    const int reads = 100;
+    bool same = true;
+    double readTime = 0.0;
+    vector<char> expected(reader.blockSize());
+    for (int i = 0; i < reads; ++i) {
+        size_t b = (size_t)rng.uniformInt(0, reader.blockCount() - 1);
+        auto start = chrono::steady_clock::now();
+        vector<unsigned char> block = reader.readBlock(b);
+        readTime += seconds(start);
+        original.seekg((uint64_t)b * reader.blockSize());
+        original.read(expected.data(), block.size());
+        same = same && memcmp(expected.data(), block.data(), block.size()) == 0;
+    }
+    cout << "Random block access: " << readTime / reads * 1e3 << " ms per " << reader.blockSize() / 1024
+         << " KB block" << (same ? "" : "  [MISMATCH]") << endl;
+    remove(path.c_str());
+    remove(packed.c_str());
+    remove(output.c_str());
+}
+
+// 规范码往返测试：BitWriter 编码后用查表解码，与原文逐字节比较；
+// 编码结果还要与逐位写入 Bitmap 的结果逐字节相同
+bool roundTrip(const string& name, const string& text) {
+    unordered_map<char, int> freqMap;
+    for (char c : text) freqMap[c]++;
+    HuffTree tree;
+    tree.build(freqMap);
+    CanonicalHuffman canonical(tree.codeLengths());
+
+    BitWriter writer;
+    canonical.encode(text, writer);
+    size_t bits = writer.bitCount();
+    const vector<unsigned char>& packed = writer.finish();
+    string decoded = canonical.decode(packed.data(), packed.size(), text.size());
+
+    Bitmap bitmap(8);
+    packWithBitmap(canonical, text, bitmap);
+    bool sameBits = memcmp(bitmap.bytes(), packed.data(), packed.size()) == 0;
+    // 码长与 HuffTree 相同，总位数也应相同(HuffTree::encode 会转小写，只能比较码长之和)
+    size_t treeBits = 0;
+    for (char c : text) treeBits += tree.getCodeMap().at(c).length();
+    bool ok = decoded == text && bits == treeBits && sameBits;
+    cout << "Round trip " << name << ": " << text.size() << " chars, " << bits << " bits"
+         << (ok ? "" : "  [MISMATCH]") << endl;
+    return ok;
+}
+
+void runRoundTripTests() {
+    cout << "\n=== Canonical Huffman round trips ===" << endl;
+    int passed = 0, total = 0;
+    string speech = lettersOnly(speechText());
+    total++; passed += roundTrip("speech", speech);
+    for (const char* word : {"dream", "freedom", "justice", "brotherhood", "nation"}) {
+        total++; passed += roundTrip(word, word);
+    }
+    total++; passed += roundTrip("single symbol", string(1000, 'a'));
+    total++; passed += roundTrip("corpus", generateCorpus(100000));
+
+    // 全部 256 个字节值，权重按斐波那契数递减，产生超过 TABLE_BITS 的长码
+    vector<double> weights(256, 1.0);
+    double a = 1.0, b = 1.0;
+    for (int c = 27; c >= 0; --c) {
+        weights[c] = b;
+        double next = a + b;
+        a = b;
+        b = next;
+    }
+    double sum = 0.0;
+    for (double w : weights) sum += w;
+    Xoshiro256 rng(DataGenerator::DEFAULT_SEED);
+    string skewed;
+    for (int c = 0; c < 256; ++c) skewed += (char)c;          // 每个字节值至少出现一次
+    for (int i = 0; i < 300000; ++i) {
+        double x = rng.uniform(0.0, sum);
+        int c = 0;
+        while (c < 255 && x >= weights[c]) x -= weights[c++];
+        skewed += (char)c;
+    }
+    total++; passed += roundTrip("256 skewed", skewed);
+
+    // 位流末尾多出的位不能让解码写出 count 之外的字节：
+    // 'a' 为 1 位码、'b' 为 12 位码，30 个 'a' 之后紧跟一个完整的 'b'
+    {
+        array<int, 256> lengths{};
+        lengths['a'] = 1;
+        lengths['b'] = 12;
+        CanonicalHuffman canonical(lengths);
+        BitWriter writer;
+        for (int i = 0; i < 30; ++i) canonical.encode(string("a"), writer);
+        canonical.encode(string("b"), writer);
+        const vector<unsigned char>& packed = writer.finish();
+        vector<unsigned char> out(31, 0xEE);                  // 最后一格是哨兵
+        canonical.decode(packed.data(), packed.size(), 30, out.data());
+        bool ok = out[30] == 0xEE && count(out.begin(), out.begin() + 30, 'a') == 30;
+        total++; passed += ok;
+        cout << "Trailing bits: " << (ok ? "bounded" : "[OVERRUN]") << endl;
+    }
+    cout << passed << "/" << total << " round trips passed" << endl;
+}
+
+// 解码基准：约 megabytes MB 的字母语料，比较逐位遍历树的 decode 与规范码查表解码
+void runDecodeBenchmark(size_t megabytes) {
+    cout << "\n=== Decode benchmark: " << megabytes << " MB ===" << endl;
+    string corpus = generateCorpus(megabytes << 20);
+    HuffTree tree;
+    tree.build(calculateFrequency(corpus));
+    CanonicalHuffman canonical(tree.codeLengths());
+
+    string bitString = tree.encode(corpus);
+    BitWriter writer;
+    canonical.encode(corpus, writer);
+    const vector<unsigned char>& packed = writer.finish();
+    size_t packedBytes = packed.size();
+
+    Benchmark bench;
+    string treeDecoded, tableDecoded(corpus.size(), '\0');
+    double treeTime = bench.run("HuffTree::decode", [&] { treeDecoded = tree.decode(bitString); }).median;
+    double tableTime = bench.run("CanonicalHuffman::decode", [&] {
+        canonical.decode(packed.data(), packedBytes, corpus.size(), (unsigned char*)&tableDecoded[0]);
+    }).median;
+    bench.printTable(cout);
+
+    double mb = (double)corpus.size() / (1 << 20);
+    cout << "Encoded input: " << bitString.size() / (1 << 20) << " MB as '0'/'1' string, "
+         << packedBytes / (1 << 20) << " MB packed" << endl;
+    cout << "HuffTree::decode:         " << mb / treeTime << " MB/s" << endl;
+    cout << "CanonicalHuffman::decode: " << mb / tableTime << " MB/s (" << treeTime / tableTime << "x)"
+         << (treeDecoded == corpus && tableDecoded == corpus ? "" : "  [MISMATCH]") << endl;
+}
+
+// 编码基准：同一语料分别用 HuffTree::encode('0'/'1' 字符串)、逐位写入 Bitmap、
+// 规范码加 BitWriter 三种方式编码，报告吞吐量与输出占用的内存
+void runEncodeBenchmark(size_t megabytes) {
+    cout << "\n=== Encode benchmark: " << megabytes << " MB ===" << endl;
+    string corpus = generateCorpus(megabytes << 20);
+    HuffTree tree;
+    tree.build(calculateFrequency(corpus));
+    CanonicalHuffman canonical(tree.codeLengths());
+
+    Benchmark bench;
+    string bitString;
+    size_t bitmapBits = 0;
+    BitWriter writer;
+    double treeTime = bench.run("HuffTree::encode", [&] { bitString = tree.encode(corpus); }).median;
+    double bitmapTime = bench.run("Bitmap pack", [&] {
+        Bitmap bitmap(8);
+        bitmapBits = packWithBitmap(canonical, corpus, bitmap);
+    }).median;
+    double writerTime = bench.run("CanonicalHuffman::encode", [&] {
+        writer.clear();
+        canonical.encode(corpus, writer);
+        writer.finish();
+    }).median;
+    bench.printTable(cout);
+
+    double mb = (double)corpus.size() / (1 << 20);
+    string decoded = canonical.decode(writer.bytes().data(), writer.bytes().size(), corpus.size());
+    cout << "HuffTree::encode:         " << mb / treeTime << " MB/s, output " << bitString.capacity() / (1 << 20)
+         << " MB" << endl;
+    cout << "Bitmap pack:              " << mb / bitmapTime << " MB/s, output " << (bitmapBits + 7) / 8 / (1 << 20)
+         << " MB" << endl;
+    cout << "CanonicalHuffman::encode: " << mb / writerTime << " MB/s, output " << writer.bytes().size() / (1 << 20)
+         << " MB (" << treeTime / writerTime << "x)" << (decoded == corpus ? "" : "  [MISMATCH]") << endl;
+}
+
+// 主函数
+int main(int argc, char* argv[]) {
+    // compress <输入> <输出> [块大小 KB] / decompress <输入> <输出>
+    if (argc >= 4 && (string(argv[1]) == "compress" || string(argv[1]) == "decompress")) {
+        try {
+            auto start = chrono::steady_clock::now();
+            HuffFileStats stats = string(argv[1]) == "compress"
+                ? HuffFile::compress(argv[2], argv[3], argc > 4 ? stoul(argv[4]) << 10 : HuffFile::DEFAULT_BLOCK)
+                : HuffFile::decompress(argv[2], argv[3]);
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << stats.inputBytes << " -> " << stats.outputBytes << " bytes in " << elapsed << " s" << endl;
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    // --parallel-bench [GB] [最大线程数] [临时文件路径]
+    if (argc > 1 && string(argv[1]) == "--parallel-bench") {
+        unsigned maxThreads = argc > 3 ? (unsigned)stoul(argv[3]) : hardwareThreads();
+        runParallelFileBenchmark(argc > 2 ? stod(argv[2]) : 1.0, max(1u, maxThreads),
+                                 argc > 4 ? argv[4] : "huff_corpus.txt");
+        return 0;
+    }
+    // --file-bench [GB] [临时文件路径]
+    if (argc > 1 && string(argv[1]) == "--file-bench") {
+        runFileBenchmark(argc > 2 ? stod(argv[2]) : 2.0, argc > 3 ? argv[3] : "huff_corpus.txt");
+        return 0;
+    }
+    // --encode-bench [MB]
+    if (argc > 1 && string(argv[1]) == "--encode-bench") {
+        runEncodeBenchmark(argc > 2 ? stoul(argv[2]) : 64);
+        return 0;
+    }
+    // --decode-bench [MB]
+    if (argc > 1 && string(argv[1]) == "--decode-bench") {
+        runDecodeBenchmark(argc > 2 ? stoul(argv[2]) : 64);
+        return 0;
+    }
+
+    string speech = speechText();
     
     // 计算字母频率
     unordered_map<char, int> freqMap = calculateFrequency(speech);
@@ -407,6 +1435,8 @@ int main() {
     cout << "Original: " << testSentence << endl;
     cout << "Encoded: " << encodedSentence << endl;
     cout << "Decoded: " << decodedSentence << endl;
-    
+
+    runRoundTripTests();
+    runFileTests();
     return 0;
 }
\ No newline at end of file
@@ -3,8 +3,13 @@
 #include <algorithm>
 #include <cmath>
 #include <chrono>
-#include <random>
 #include <iomanip>
+#include <fstream>
+#include <string>
+
+#include "../common/merge_sort.h"
+#include "../common/benchmark.h"
+#include "../common/data_generator.h"
 
 using namespace std;
 
@@ -94,6 +99,18 @@ void mergeSort(vector<BoundingBox>& arr, int left, int right) {
     merge(arr, left, mid, right);
 }
 
+// B2. Bottom-Up Merge Sort (O(n log n))
+// One scratch buffer for the whole sort, insertion sort for short runs.
+// With naturalRuns, already-ordered stretches are merged as-is, so presorted
+// detector output costs close to a single linear scan.
+bool scoreGreater(const BoundingBox& a, const BoundingBox& b) {
+    return a.score > b.score;
+}
+
+void bottomUpSort(vector<BoundingBox>& arr, bool naturalRuns = false) {
+    bottomUpMergeSort(arr, scoreGreater, naturalRuns);
+}
+
 // C. Heap Sort (O(n log n))
 // Standard HeapSort builds a Max-Heap to get Ascending order.
 // To get Descending order [Max...Min], we can build a Min-Heap.
@@ -171,71 +188,82 @@ vector<BoundingBox> runNMS(vector<BoundingBox>& boxes, float iouThreshold) {
 
 // --- 5. Data Generation Utilities ---
 
-vector<BoundingBox> generateRandom(int count) {
-    vector<BoundingBox> boxes;
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<> disLoc(0, 800);
-    uniform_real_distribution<> disSize(20, 100);
-    uniform_real_distribution<> disScore(0, 1);
-
-    for (int i = 0; i < count; ++i) {
-        boxes.push_back({
-            i,
-            (float)disLoc(gen), (float)disLoc(gen),
-            (float)disSize(gen), (float)disSize(gen),
-            (float)disScore(gen)
-        });
-    }
-    return boxes;
+// All generators are deterministic for a given seed and fill large datasets
+// in parallel blocks (see common/data_generator.h).
+
+vector<BoundingBox> generateRandom(int count, uint64_t seed) {
+    return DataGenerator::generate<BoundingBox>(count, seed, [](Xoshiro256& rng, size_t i) {
+        BoundingBox box;
+        box.id = (int)i;
+        box.x = (float)rng.uniform(0, 800);
+        box.y = (float)rng.uniform(0, 800);
+        box.w = (float)rng.uniform(20, 100);
+        box.h = (float)rng.uniform(20, 100);
+        box.score = (float)rng.uniform(0, 1);
+        return box;
+    });
 }
 
-vector<BoundingBox> generateClustered(int count) {
-    vector<BoundingBox> boxes;
-    random_device rd;
-    mt19937 gen(rd());
+vector<BoundingBox> generateClustered(int count, uint64_t seed) {
+    Xoshiro256 gen(seed);
     
     // Create random cluster centers
     int numClusters = max(3, count / 100);
     vector<pair<float, float>> clusters;
-    uniform_real_distribution<> disC(100, 700);
     for(int i=0; i<numClusters; ++i) 
-        clusters.push_back({(float)disC(gen), (float)disC(gen)});
-
-    uniform_real_distribution<> disOffset(-100, 100);
-    uniform_real_distribution<> disSize(20, 80);
-    uniform_real_distribution<> disScoreBase(0.5, 1.0);
+        clusters.push_back({(float)gen.uniform(100, 700), (float)gen.uniform(100, 700)});
 
-    for (int i = 0; i < count; ++i) {
+    return DataGenerator::generate<BoundingBox>(count, seed + 1, [&](Xoshiro256& rng, size_t i) {
         auto center = clusters[i % numClusters];
-        float offX = disOffset(gen);
-        float offY = disOffset(gen);
+        float offX = (float)rng.uniform(-100, 100);
+        float offY = (float)rng.uniform(-100, 100);
         // Scores are often higher near cluster centers
-        float score = max(0.0f, min(1.0f, (float)(disScoreBase(gen) - (abs(offX)/500.0f))));
-
-        boxes.push_back({
-            i,
-            center.first + offX, center.second + offY,
-            (float)disSize(gen), (float)disSize(gen),
-            score
-        });
-    }
+        float score = max(0.0f, min(1.0f, (float)(rng.uniform(0.5, 1.0) - (abs(offX)/500.0f))));
+
+        BoundingBox box;
+        box.id = (int)i;
+        box.x = center.first + offX;
+        box.y = center.second + offY;
+        box.w = (float)rng.uniform(20, 80);
+        box.h = (float)rng.uniform(20, 80);
+        box.score = score;
+        return box;
+    });
+}
+
+// Detectors often emit boxes already ranked by score
+vector<BoundingBox> generatePresorted(int count, uint64_t seed) {
+    auto boxes = generateRandom(count, seed);
+    sort(boxes.begin(), boxes.end(), scoreGreater);
     return boxes;
 }
 
 // --- 6. Benchmarking Logic ---
 
-void runBenchmark(int count, string distName, vector<BoundingBox>(*genFunc)(int)) {
+using SortFunc = void (*)(vector<BoundingBox>&);
+
+// Each sort and NMS pass runs through the shared harness: warm-up, repeated
+// trials, and the median is reported. Input copies happen outside the timed region.
+void runBenchmark(int count, string distName, vector<BoundingBox>(*genFunc)(int, uint64_t), uint64_t seed,
+                  Benchmark& bench) {
     cout << "\n=================================================" << endl;
     cout << "  Dataset: " << count << " boxes (" << distName << ")" << endl;
     cout << "=================================================" << endl;
     
-    auto boxes = genFunc(count);
+    auto boxes = genFunc(count, seed);
     float threshold = 0.5f;
 
-    vector<string> algoNames = {"Quick", "Merge", "Heap", "Bubble"};
-    
-    // Print Table Header
+    // Each sort is resolved here, so the timed region calls it directly
+    const vector<pair<string, SortFunc>> algorithms = {
+        {"Quick", [](vector<BoundingBox>& v) { quickSort(v, 0, v.size() - 1); }},
+        {"Merge", [](vector<BoundingBox>& v) { mergeSort(v, 0, v.size() - 1); }},
+        {"MergeBU", [](vector<BoundingBox>& v) { bottomUpSort(v); }},
+        {"Natural", [](vector<BoundingBox>& v) { bottomUpSort(v, true); }},
+        {"Heap", heapSort},
+        {"Bubble", bubbleSort},
+    };
+
+    // Print Table Header (median of the trials)
     cout << left << setw(10) << "Algo" 
          << setw(12) << "Sort(ms)" 
          << setw(12) << "NMS(ms)" 
@@ -243,47 +271,66 @@ void runBenchmark(int count, string distName, vector<BoundingBox>(*genFunc)(int)
          << "Kept" << endl;
     cout << string(55, '-') << endl;
 
-    for (const auto& name : algoNames) {
-        // Deep copy for fair testing
-        vector<BoundingBox> copy = boxes;
-        
+    for (const auto& [name, sortFunc] : algorithms) {
+        const string prefix = to_string(count) + "/" + distName + "/" + name;
+        vector<BoundingBox> copy;
+
         // 1. Measure Sort
-        auto startSort = chrono::high_resolution_clock::now();
-        if (name == "Quick") quickSort(copy, 0, copy.size() - 1);
-        else if (name == "Merge") mergeSort(copy, 0, copy.size() - 1);
-        else if (name == "Heap") heapSort(copy);
-        else if (name == "Bubble") bubbleSort(copy);
-        auto endSort = chrono::high_resolution_clock::now();
-        
-        // 2. Measure NMS
-        auto startNMS = chrono::high_resolution_clock::now();
-        auto result = runNMS(copy, threshold);
-        auto endNMS = chrono::high_resolution_clock::now();
-
-        chrono::duration<double, milli> sortDur = endSort - startSort;
-        chrono::duration<double, milli> nmsDur = endNMS - startNMS;
-        double total = sortDur.count() + nmsDur.count();
+        double sortMs = bench.run(prefix + "/sort",
+                                  [&] { copy = boxes; },
+                                  [&, sortFunc = sortFunc] { sortFunc(copy); }).median * 1e3;
+
+        // 2. Measure NMS on the sorted boxes
+        vector<BoundingBox> result;
+        double nmsMs = bench.run(prefix + "/nms", [&] { result = runNMS(copy, threshold); }).median * 1e3;
 
         cout << left << setw(10) << name 
              << fixed << setprecision(3)
-             << setw(12) << sortDur.count() 
-             << setw(12) << nmsDur.count() 
-             << setw(12) << total 
+             << setw(12) << sortMs 
+             << setw(12) << nmsMs 
+             << setw(12) << sortMs + nmsMs 
              << result.size() << endl;
     }
 }
 
-int main() {
+// Usage: exp4 [--seed n] [--trials n] [--counters] [--csv file] [--json file]
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    string csvPath, jsonPath;
+    uint64_t seed = DataGenerator::DEFAULT_SEED;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = stoull(argv[++i]);
+        else if (arg == "--trials" && i + 1 < argc) options.trials = stoi(argv[++i]);
+        else if (arg == "--counters") options.counters = true;
+        else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+    }
+    if (options.counters && !PerfCounters().available()) {
+        cout << "Hardware counters unavailable (perf_event_open failed); timing only." << endl;
+    }
+    Benchmark bench(options);
+
     cout << "NMS Algorithm Performance Analysis" << endl;
-    cout << "Comparing Quick, Merge, Heap, and Bubble Sort impact on NMS." << endl;
+    cout << "Comparing Quick, Merge (top-down, bottom-up, natural), Heap, and Bubble Sort impact on NMS." << endl;
     
     // Define test scales
     // Note: Bubble sort will be very slow on 10,000!
     vector<int> counts = {100, 1000, 5000};
     
     for (int n : counts) {
-        runBenchmark(n, "Random Dist", generateRandom);
-        runBenchmark(n, "Clustered Dist", generateClustered);
+        runBenchmark(n, "Random Dist", generateRandom, seed, bench);
+        runBenchmark(n, "Clustered Dist", generateClustered, seed, bench);
+        runBenchmark(n, "Presorted", generatePresorted, seed, bench);
+    }
+
+    if (!csvPath.empty()) {
+        ofstream csv(csvPath);
+        bench.writeCsv(csv);
+    }
+    if (!jsonPath.empty()) {
+        ofstream json(jsonPath);
+        bench.writeJson(json);
     }
     
     return 0;